@@ -40,8 +40,22 @@ namespace proptest {
  */
 struct ForAllConfig {
     optional<uint64_t> seed = nullopt;
+    /// Random engine; a seed reproduces its values only with the same engine
+    optional<RandomEngine> randomEngine = nullopt;
     optional<uint32_t> numRuns = nullopt;
     optional<uint32_t> maxDurationMs = nullopt;
+    /// Wall-clock budget in ms that the number of runs is planned for (numRuns becomes an upper bound)
+    optional<uint32_t> timeBudgetMs = nullopt;
+    /// Grow the size of generated containers from small to their maxSize over the runs
+    optional<bool> growSize = nullopt;
+    /// Number of worker threads for the run loop (1 = run on the calling thread)
+    optional<uint32_t> numThreads = nullopt;
+    /// Draws a filter makes for one value before the run is discarded (0 = no limit)
+    optional<uint32_t> maxFilterAttempts = nullopt;
+    /// Discarded runs allowed per run of numRuns before giving up (0 = no limit)
+    optional<uint32_t> maxDiscardRatio = nullopt;
+    /// Acceptance rate of runs or filter draws below which a warning is printed
+    optional<double> minAcceptanceRate = nullopt;
     optional<Function<void()>> onStartup = nullopt;
     optional<Function<void()>> onCleanup = nullopt;
     /// Max retries per shrink candidate; total trials = 1 + n (0 = deterministic)
@@ -50,6 +64,12 @@ struct ForAllConfig {
     optional<uint32_t> shrinkTimeoutMs = nullopt;
     /// Per-candidate timeout in ms (0 = no limit)
     optional<uint32_t> shrinkRetryTimeoutMs = nullopt;
+    /// Number of shrink candidates tested concurrently (1 = one at a time)
+    optional<uint32_t> shrinkNumThreads = nullopt;
+    /// Skip shrink candidates whose printed args already passed (false = test every candidate)
+    optional<bool> shrinkCache = nullopt;
+    /// Collect per-phase timing of the run and print it after the run (see Property::getLastRunStats)
+    optional<bool> collectRunStats = nullopt;
     /// Optional output stream for informational logs (defaults to stdout)
     optional<ostream*> outputStream = nullopt;
     /// Optional error stream for failure logs (defaults to stderr)
@@ -75,12 +95,33 @@ void applyConfig(Property<ARGS...>& prop, const ForAllConfig& config)
     if (config.seed.has_value()) {
         prop.setSeed(config.seed.value());
     }
+    if (config.randomEngine.has_value()) {
+        prop.setRandomEngine(config.randomEngine.value());
+    }
     if (config.numRuns.has_value()) {
         prop.setNumRuns(config.numRuns.value());
     }
     if (config.maxDurationMs.has_value()) {
         prop.setMaxDurationMs(config.maxDurationMs.value());
     }
+    if (config.timeBudgetMs.has_value()) {
+        prop.setTimeBudgetMs(config.timeBudgetMs.value());
+    }
+    if (config.growSize.has_value()) {
+        prop.setGrowSize(config.growSize.value());
+    }
+    if (config.numThreads.has_value()) {
+        prop.setNumThreads(config.numThreads.value());
+    }
+    if (config.maxFilterAttempts.has_value()) {
+        prop.setMaxFilterAttempts(config.maxFilterAttempts.value());
+    }
+    if (config.maxDiscardRatio.has_value()) {
+        prop.setMaxDiscardRatio(config.maxDiscardRatio.value());
+    }
+    if (config.minAcceptanceRate.has_value()) {
+        prop.setMinAcceptanceRate(config.minAcceptanceRate.value());
+    }
     if (config.onStartup.has_value()) {
         prop.setOnStartup(config.onStartup.value());
     }
@@ -96,6 +137,15 @@ void applyConfig(Property<ARGS...>& prop, const ForAllConfig& config)
     if (config.shrinkRetryTimeoutMs.has_value()) {
         prop.setShrinkRetryTimeoutMs(config.shrinkRetryTimeoutMs.value());
     }
+    if (config.shrinkNumThreads.has_value()) {
+        prop.setShrinkNumThreads(config.shrinkNumThreads.value());
+    }
+    if (config.shrinkCache.has_value()) {
+        prop.setShrinkCache(config.shrinkCache.value());
+    }
+    if (config.collectRunStats.has_value()) {
+        prop.setCollectRunStats(config.collectRunStats.value());
+    }
     if (config.outputStream.has_value() && config.outputStream.value() != nullptr) {
         prop.setOutputStream(*config.outputStream.value());
     }
@@ -138,6 +188,21 @@ public:
         return *this;
     }
 
+    /**
+     * @brief Sets the random engine used for input generation
+     *
+     * RandomEngine::XOSHIRO256SS is faster and much cheaper to copy than the default
+     * RandomEngine::MT19937_64, but draws different values for the same seed.
+     *
+     * @param engine Random engine. Default is PROPTEST_RANDOM_ENGINE if set, else MT19937_64
+     * @return Property& `Property` object itself for chaining
+     */
+    Property& setRandomEngine(RandomEngine engine)
+    {
+        randomEngine = engine;
+        return *this;
+    }
+
     /**
      * @brief Sets the number of runs
      *
@@ -186,6 +251,101 @@ public:
         return *this;
     }
 
+    /**
+     * @brief Sets the time budget of the run loop.
+     *
+     * The first util::kBudgetCalibrationRuns runs measure the cost of a test case, then the number of runs is
+     * planned to fit in the budget. The number of runs (setNumRuns or the default) becomes an upper bound, and the
+     * run loop stops when the budget is used up. Without this, a property takes its share of
+     * util::TimeBudget::global() when that is active.
+     *
+     * @param budgetMs time budget in milliseconds. 0 means no budget, even if the global one is active.
+     * @return Property& `Property` object itself for chaining
+     */
+    Property& setTimeBudgetMs(uint32_t budgetMs)
+    {
+        timeBudgetMs = budgetMs;
+        return *this;
+    }
+
+    /**
+     * @brief Grows the size of generated values over the runs.
+     *
+     * Run i of n generates containers and strings with at most minSize + (maxSize - minSize) * (i + 1) / n
+     * elements, so that cheap small cases run first and the last runs reach the full maxSize. The size is carried
+     * by Random (see Random::getSizeFactor()), so custom generators can follow it with
+     * Random::getRandomContainerSize().
+     *
+     * @param enable whether to grow sizes. Default is false meaning sizes are drawn up to maxSize from the first run.
+     * @return Property& `Property` object itself for chaining
+     */
+    Property& setGrowSize(bool enable)
+    {
+        growSize = enable;
+        return *this;
+    }
+
+    /**
+     * @brief Sets how many values a filter draws for one argument before giving up on the run.
+     *
+     * A filter (gen::filter, Generator::filter) that draws this many rejected values in a row discards the run, as
+     * PROP_DISCARD does, instead of looping until a value is accepted.
+     *
+     * @param attempts max draws per value. Default is 10000. 0 means no limit.
+     * @return Property& `Property` object itself for chaining
+     */
+    Property& setMaxFilterAttempts(uint32_t attempts)
+    {
+        maxFilterAttempts = attempts;
+        return *this;
+    }
+
+    /**
+     * @brief Sets how many runs may be discarded, relative to the number of runs, before the property gives up.
+     *
+     * Runs are discarded by PROP_DISCARD and by filters that reach the max filter attempts. When more than
+     * ratio * numRuns runs are discarded, the property stops and fails with "Gave up", as its arguments are too rarely
+     * valid to test it.
+     *
+     * @param ratio discarded runs allowed per run. Default is 10. 0 means no limit.
+     * @return Property& `Property` object itself for chaining
+     */
+    Property& setMaxDiscardRatio(uint32_t ratio)
+    {
+        maxDiscardRatio = ratio;
+        return *this;
+    }
+
+    /**
+     * @brief Sets the acceptance rate below which a warning is printed after the run.
+     *
+     * Checked for the runs (those not discarded) and for the filter draws of each argument.
+     *
+     * @param rate acceptance rate in [0, 1]. Default is 0.1. 0 disables the warnings.
+     * @return Property& `Property` object itself for chaining
+     */
+    Property& setMinAcceptanceRate(double rate)
+    {
+        minAcceptanceRate = rate;
+        return *this;
+    }
+
+    /**
+     * @brief Sets the number of worker threads for the run loop.
+     *
+     * Runs are split across threads, each drawing from its own random stream derived from the seed.
+     * The failure with the lowest run index is shrunk on the calling thread. The property function and
+     * onStartup/onCleanup callbacks must be thread-safe when this is greater than 1.
+     *
+     * @param threads number of threads. Default is 1 meaning the calling thread runs every test.
+     * @return Property& `Property` object itself for chaining
+     */
+    Property& setNumThreads(uint32_t threads)
+    {
+        numThreads = threads;
+        return *this;
+    }
+
     /**
      * @brief Sets max retries per shrink candidate (0 = deterministic, one run per candidate)
      */
@@ -213,6 +373,81 @@ public:
         return *this;
     }
 
+    /**
+     * @brief Sets the number of shrink candidates tested concurrently.
+     *
+     * The next `threads` candidates of the shrink stream are tested in parallel, and the first failing one in
+     * stream order is taken, so the shrinking result is the same as with sequential shrinking. The property
+     * function and onStartup/onCleanup callbacks must be thread-safe when this is greater than 1.
+     *
+     * @param threads number of threads. Default is 1 meaning candidates are tested one at a time.
+     * @return Property& `Property` object itself for chaining
+     */
+    Property& setShrinkNumThreads(uint32_t threads)
+    {
+        shrinkNumThreads = threads;
+        return *this;
+    }
+
+    /**
+     * @brief Enables the cache of passing shrink candidates.
+     *
+     * During shrinking, args that already passed are not tested again. Candidates are identified by their printed
+     * form, or by the function given to setShrinkCacheHash(). Only useful for deterministic
+     * properties, and when printing an argument tells its values apart.
+     *
+     * @param enable whether to cache passing candidates. Default is false.
+     * @return Property& `Property` object itself for chaining
+     */
+    Property& setShrinkCache(bool enable)
+    {
+        shrinkCache = enable;
+        return *this;
+    }
+
+    /**
+     * @brief Enables the cache of passing shrink candidates, identified by the given hash of the args
+     *
+     * Candidates with equal hashes are considered the same, so the hash should not collide for args that
+     * behave differently.
+     */
+    Property& setShrinkCacheHash(Function<size_t(const decay_t<ARGS>&...)> hashFunc)
+    {
+        shrinkCache = true;
+        shrinkCacheHash = [hashFunc](const vector<ShrinkableBase>& shrVec) -> size_t {
+            return util::Call<Arity>(hashFunc, [&](auto index_sequence) -> decltype(auto) {
+                using ArgT = tuple_element_t<index_sequence.value, ArgTuple>;
+                return shrVec[index_sequence.value].getAny().template getRef<ArgT>();
+            });
+        };
+        return *this;
+    }
+
+    /**
+     * @brief Collects the time spent in each phase of forAll runs and prints it after each run
+     *
+     * Reports time in generation, the property function, onStartup, onCleanup and shrinking, and the number of
+     * shrink candidates tested. Heap allocations per phase are reported when util::setAllocationCounter() is set.
+     * The stats of the last run are available from getLastRunStats().
+     *
+     * @param enable whether to collect and print run stats. Default is false.
+     * @return Property& `Property` object itself for chaining
+     */
+    Property& setCollectRunStats(bool enable)
+    {
+        collectRunStats = enable;
+        return *this;
+    }
+
+    /**
+     * @brief Sets callback invoked with the run stats after each forAll run; collects them without printing
+     */
+    Property& setOnRunStats(Function<void(RunStats)> f)
+    {
+        PropertyBase::setOnRunStats(util::move(f));
+        return *this;
+    }
+
     /**
      * @brief Sets callback invoked after each assessment (reproduction rate measurement)
      */
@@ -395,12 +630,21 @@ private:
 
     virtual bool callFunctionFromGen(Random& rand, const vector<AnyGenerator>& genVec) override {
         vector<Any> argVec; // make sure generated values are intact when passed as reference to the func throughout the call
-        return util::Call<Arity>(func, [&](auto index_sequence) -> decltype(auto) {
-            using ArgT = tuple_element_t<index_sequence.value, ArgTuple>;
-            Any arg = genVec[index_sequence.value](rand).getAny();
-            argVec.push_back(arg);
-            return arg.template getRef<ArgT>();
-        });
+        argVec.reserve(Arity);
+        // generate in parameter order (function arguments are evaluated in unspecified order), so that shrink() can
+        // regenerate the same values from the saved random state
+        {
+            util::PhaseTimer timer(getPhaseStats(&RunStats::generation));
+            util::DiscardStats* discardStats = util::getDiscardStats();
+            for (size_t i = 0; i < Arity; i++) {
+                // filters count their draws by the argument they generate
+                if (discardStats)
+                    discardStats->currentArg = i;
+                argVec.push_back(genVec[i](rand).getAny());
+            }
+        }
+        util::PhaseTimer timer(getPhaseStats(&RunStats::function));
+        return callFunction(argVec);
     }
 
     virtual void writeArgs(ostream& os, const vector<ShrinkableBase>& shrVec) const override
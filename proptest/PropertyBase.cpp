@@ -2,9 +2,15 @@
 #include "proptest/util/assert.hpp"
 #include "proptest/std/chrono.hpp"
 #include "proptest/std/pair.hpp"
+#include "proptest/std/set.hpp"
+#include "proptest/std/functional.hpp"
+#include "proptest/std/limits.hpp"
 #include "proptest/Random.hpp"
 #include "proptest/PropertyContext.hpp"
 #include "proptest/Shrinkable.hpp"
+#include "proptest/std/thread.hpp"
+#include "proptest/util/thread_pool.hpp"
+#include "proptest/util/time_budget.hpp"
 
 namespace proptest {
 
@@ -23,7 +29,26 @@ uint64_t getGlobalSeed()
 
 }  // namespace util
 
-PropertyContext* PropertyBase::context = nullptr;
+namespace {
+
+thread_local PropertyContext* context = nullptr;
+thread_local RunStats* runStats = nullptr;
+
+// makes stats the run stats of the calling thread for the lifetime of the binding
+class RunStatsBinding
+{
+public:
+    explicit RunStatsBinding(RunStats* stats) : oldStats(runStats) { runStats = stats; }
+    ~RunStatsBinding() { runStats = oldStats; }
+    RunStatsBinding(const RunStatsBinding&) = delete;
+    RunStatsBinding& operator=(const RunStatsBinding&) = delete;
+
+private:
+    RunStats* oldStats;
+};
+
+}  // namespace
+
 uint32_t PropertyBase::defaultNumRuns = 1000;
 uint32_t PropertyBase::defaultMaxDurationMs = 0;
 
@@ -32,6 +57,16 @@ void PropertyBase::setContext(PropertyContext* ctx)
     context = ctx;
 }
 
+PropertyContext* PropertyBase::getContext()
+{
+    return context;
+}
+
+RunStats* PropertyBase::getRunStats()
+{
+    return runStats;
+}
+
 void PropertyBase::tag(const char* file, int lineno, string key, string value)
 {
     if (!context)
@@ -40,22 +75,55 @@ void PropertyBase::tag(const char* file, int lineno, string key, string value)
     context->tag(file, lineno, key, value);
 }
 
-void PropertyBase::addStatAssertGe(string&& key, double bound, const char* filename, int lineno)
+void PropertyBase::tagBool(const char* file, int lineno, string_view key, bool value)
+{
+    if (!context)
+        throw runtime_error(__FILE__, __LINE__, "context is not set");
+
+    context->tagBool(file, lineno, key, value);
+}
+
+void PropertyBase::tagInt(const char* file, int lineno, string_view key, int64_t value)
+{
+    if (!context)
+        throw runtime_error(__FILE__, __LINE__, "context is not set");
+
+    context->tagInt(file, lineno, key, value);
+}
+
+void PropertyBase::tagUInt(const char* file, int lineno, string_view key, uint64_t value)
+{
+    if (!context)
+        throw runtime_error(__FILE__, __LINE__, "context is not set");
+
+    context->tagUInt(file, lineno, key, value);
+}
+
+void PropertyBase::tagNumeric(const char* file, int lineno, string_view key, double value)
+{
+    if (!context)
+        throw runtime_error(__FILE__, __LINE__, "context is not set");
+
+    context->tagNumeric(file, lineno, key, value);
+}
+
+void PropertyBase::addStatAssertGe(string&& key, double bound, const char* filename, int lineno, StatMeasure measure)
 {
     if (context)
-        context->addStatAssertGe(util::move(key), bound, filename, lineno);
+        context->addStatAssertGe(util::move(key), bound, filename, lineno, measure);
 }
 
-void PropertyBase::addStatAssertLe(string&& key, double bound, const char* filename, int lineno)
+void PropertyBase::addStatAssertLe(string&& key, double bound, const char* filename, int lineno, StatMeasure measure)
 {
     if (context)
-        context->addStatAssertLe(util::move(key), bound, filename, lineno);
+        context->addStatAssertLe(util::move(key), bound, filename, lineno, measure);
 }
 
-void PropertyBase::addStatAssertInRange(string&& key, double minBound, double maxBound, const char* filename, int lineno)
+void PropertyBase::addStatAssertInRange(string&& key, double minBound, double maxBound, const char* filename, int lineno,
+                                        StatMeasure measure)
 {
     if (context)
-        context->addStatAssertInRange(util::move(key), minBound, maxBound, filename, lineno);
+        context->addStatAssertInRange(util::move(key), minBound, maxBound, filename, lineno, measure);
 }
 
 void PropertyBase::succeed(const char* file, int lineno, const char* condition, const stringstream& str)
@@ -66,12 +134,13 @@ void PropertyBase::succeed(const char* file, int lineno, const char* condition,
     context->succeed(file, lineno, condition, str);
 }
 
-void PropertyBase::fail(const char* file, int lineno, const char* condition, const stringstream& str)
+ExpectStream PropertyBase::fail(const char* file, int lineno, const char* condition, const stringstream& str)
 {
     if (!context)
         throw runtime_error(__FILE__, __LINE__, "context is not set");
 
     context->fail(file, lineno, condition, str);
+    return ExpectStream(context->getLastStream());
 }
 
 bool PropertyBase::invoke(Random&)
@@ -113,20 +182,85 @@ bool PropertyBase::exampleImpl(const vector<Any>& values)
 }
 
 bool PropertyBase::runForAll(const GenVec& curGenVec)
+{
+    util::TimeBudgetCharge budgetCharge;
+    const bool printRunStats = collectRunStats.value_or(false);
+    if (!printRunStats && !onRunStats)
+        return runForAllImpl(curGenVec);
+
+    RunStats stats;
+    stats.countsAllocations = util::getAllocationCounter() != nullptr;
+    bool result;
+    {
+        RunStatsBinding binding(&stats);
+        result = runForAllImpl(curGenVec);
+    }
+    lastRunStats = stats;
+    if (printRunStats)
+        *outputStream << stats;
+    if (onRunStats)
+        onRunStats(stats);
+    return result;
+}
+
+bool PropertyBase::runForAllImpl(const GenVec& curGenVec)
 {
     const uint64_t effectiveSeed = seed.value_or(util::getGlobalSeed());
+    const RandomEngine effectiveEngine = randomEngine.value_or(util::getGlobalRandomEngine());
     const uint32_t effectiveNumRuns = numRuns.value_or(defaultNumRuns);
     const uint32_t effectiveMaxDurationMs = maxDurationMs.value_or(defaultMaxDurationMs);
+    const uint32_t effectiveNumThreads = numThreads.value_or(1);
+    const bool effectiveGrowSize = growSize.value_or(false);
+    const uint64_t effectiveTimeBudgetMs =
+        timeBudgetMs.has_value() ? timeBudgetMs.value() : util::TimeBudget::global().nextShareMs();
+
+    *outputStream << "random seed: " << effectiveSeed;
+    if (effectiveEngine != RandomEngine::MT19937_64)
+        *outputStream << " (" << util::randomEngineName(effectiveEngine) << ")";
+    *outputStream << endl;
+    if (effectiveNumThreads > 1) {
+        // workers do not calibrate, so the budget only bounds the run loop like maxDurationMs
+        uint32_t deadlineMs = effectiveMaxDurationMs;
+        if (effectiveTimeBudgetMs != 0 && (deadlineMs == 0 || effectiveTimeBudgetMs < deadlineMs))
+            deadlineMs = effectiveTimeBudgetMs < numeric_limits<uint32_t>::max()
+                             ? static_cast<uint32_t>(effectiveTimeBudgetMs)
+                             : numeric_limits<uint32_t>::max();
+        return runForAllParallel(curGenVec, effectiveSeed, effectiveEngine, effectiveNumRuns, deadlineMs,
+                                 effectiveNumThreads, effectiveGrowSize);
+    }
 
-    Random rand(effectiveSeed);
-    Random savedRand(effectiveSeed);
-    *outputStream << "random seed: " << effectiveSeed << endl;
+    Random rand(effectiveSeed, effectiveEngine);
+    Random savedRand(effectiveSeed, effectiveEngine);
     PropertyContext ctx;
+    util::DiscardStats discardStats;
+    discardStats.maxFilterAttempts = maxFilterAttempts.value_or(util::kDefaultMaxFilterAttempts);
+    util::DiscardStatsBinding discardBinding(&discardStats);
+    const uint64_t maxDiscards = static_cast<uint64_t>(maxDiscardRatio.value_or(defaultMaxDiscardRatio)) * effectiveNumRuns;
     auto startedTime = steady_clock::now();
 
+    // with a time budget, the number of runs is planned from the cost of the first ones
+    uint32_t plannedNumRuns = effectiveNumRuns;
+
     size_t i = 0;
     try {
-        for (; i < effectiveNumRuns; i++) {
+        for (; i < plannedNumRuns; i++) {
+            if (effectiveTimeBudgetMs != 0) {
+                const double elapsedMs =
+                    std::chrono::duration<double, std::milli>(steady_clock::now() - startedTime).count();
+                if (i == util::kBudgetCalibrationRuns) {
+                    plannedNumRuns = util::planNumRuns(effectiveNumRuns, static_cast<uint32_t>(i), elapsedMs,
+                                                       effectiveTimeBudgetMs);
+                    *outputStream << "Planned " << plannedNumRuns << " runs for a time budget of "
+                                  << effectiveTimeBudgetMs << "ms" << endl;
+                }
+                if (elapsedMs >= static_cast<double>(effectiveTimeBudgetMs)) {
+                    *outputStream << "Time budget of " << effectiveTimeBudgetMs << "ms used up, passed " << i
+                                  << " tests" << endl;
+                    return finishRun(ctx, i, discardStats);
+                }
+                if (i >= plannedNumRuns)
+                    break;
+            }
             if (effectiveMaxDurationMs != 0) {
                 auto currentTime = steady_clock::now();
                 if (duration_cast<util::milliseconds>(currentTime - startedTime).count() > effectiveMaxDurationMs)
@@ -134,28 +268,28 @@ bool PropertyBase::runForAll(const GenVec& curGenVec)
                     *outputStream << "Timed out after "
                                   << duration_cast<util::milliseconds>(currentTime - startedTime).count() << "ms, passed "
                                   << i << " tests" << endl;
-                    if (!ctx.checkStatAssertions(i)) {
-                        stringstream failures = ctx.flushFailures();
-                        *errorStream << "Stat assertion failed: " << failures.str() << endl;
-                        ctx.printSummary(*outputStream);
-                        return false;
-                    }
-                    ctx.printSummary(*outputStream);
-                    return true;
+                    return finishRun(ctx, i, discardStats);
                 }
             }
+            // set before the Random is saved, so that shrinking regenerates the failing args at the same size
+            if (effectiveGrowSize)
+                rand.setSizeFactor(static_cast<double>(i + 1) / plannedNumRuns);
             bool pass = true;
             do {
                 pass = true;
                 try {
                     savedRand = rand;
-                    if (onStartup)
+                    if (onStartup) {
+                        util::PhaseTimer timer(getPhaseStats(&RunStats::startup));
                         onStartup();
+                    }
                     // generate values
                     bool result = callFunctionFromGen(rand, curGenVec);
 
-                    if (onCleanup)
+                    if (onCleanup) {
+                        util::PhaseTimer timer(getPhaseStats(&RunStats::cleanup));
                         onCleanup();
+                    }
                     stringstream failures = ctx.flushFailures();
                     // failed expectations
                     if (failures.rdbuf()->in_avail()) {
@@ -172,8 +306,14 @@ bool PropertyBase::runForAll(const GenVec& curGenVec)
                 } catch (const Success&) {
                     pass = true;
                 } catch (const Discard&) {
-                    // silently discard combination
+                    // discard combination, until too many have been discarded to test the property
                     pass = false;
+                    if (++discardStats.numDiscarded > maxDiscards && maxDiscards != 0) {
+                        *errorStream << "Gave up after " << i << " tests: " << discardStats.numDiscarded
+                                     << " runs discarded" << endl;
+                        reportDiscards(discardStats, i);
+                        return false;
+                    }
                 }
             } while (!pass);
         }
@@ -196,8 +336,14 @@ bool PropertyBase::runForAll(const GenVec& curGenVec)
         return false;
     }
 
-    *outputStream << "OK, passed " << effectiveNumRuns << " tests" << endl;
-    if (!ctx.checkStatAssertions(i)) {
+    *outputStream << "OK, passed " << i << " tests" << endl;
+    return finishRun(ctx, i, discardStats);
+}
+
+bool PropertyBase::finishRun(PropertyContext& ctx, size_t numPassed, const util::DiscardStats& discardStats)
+{
+    reportDiscards(discardStats, numPassed);
+    if (!ctx.checkStatAssertions(numPassed)) {
         stringstream failures = ctx.flushFailures();
         *errorStream << "Stat assertion failed: " << failures.str() << endl;
         ctx.printSummary(*outputStream);
@@ -207,6 +353,180 @@ bool PropertyBase::runForAll(const GenVec& curGenVec)
     return true;
 }
 
+void PropertyBase::reportDiscards(const util::DiscardStats& discardStats, size_t numPassed) const
+{
+    const double minRate = minAcceptanceRate.value_or(defaultMinAcceptanceRate);
+    if (discardStats.numDiscarded > 0) {
+        const double rate = static_cast<double>(numPassed) / static_cast<double>(numPassed + discardStats.numDiscarded);
+        *outputStream << "  discarded: " << discardStats.numDiscarded << " runs (" << rate * 100 << "% accepted)"
+                      << endl;
+        if (rate < minRate)
+            *errorStream << "Warning: only " << rate * 100 << "% of the runs were not discarded" << endl;
+    }
+    for (size_t i = 0; i < discardStats.filters.size(); i++) {
+        const util::FilterCount& count = discardStats.filters[i];
+        if (count.numAccepted == count.numDraws)
+            continue;
+        const double rate = count.acceptanceRate();
+        *outputStream << "  filter of arg " << i << ": accepted " << count.numAccepted << " of " << count.numDraws
+                      << " draws (" << rate * 100 << "%)" << endl;
+        if (rate < minRate)
+            *errorStream << "Warning: filter of arg " << i << " accepted only " << rate * 100
+                         << "% of the values drawn; consider generating valid values directly" << endl;
+    }
+}
+
+bool PropertyBase::runForAllParallel(const GenVec& curGenVec, uint64_t effectiveSeed, RandomEngine effectiveEngine,
+    uint32_t effectiveNumRuns, uint32_t effectiveMaxDurationMs, uint32_t effectiveNumThreads, bool effectiveGrowSize)
+{
+    // first failure of a worker; its saved Random regenerates the failing arguments for shrink()
+    struct WorkerFailure {
+        Random savedRand;
+        string detail;
+        uint64_t runIndex;
+    };
+
+    // run i of worker w is run i * numThreads + w of the whole run. The failure with the lowest index is reported,
+    // and workers go on until they pass that index, so a seed reports and shrinks the same failure every time
+    PropertyContext total;
+    util::DiscardStats totalDiscards;
+    mutex mtx;  // guards total and totalDiscards
+    vector<optional<WorkerFailure>> failures(effectiveNumThreads);
+    atomic<uint64_t> failureIndex{numeric_limits<uint64_t>::max()};
+    atomic<bool> stop{false};
+    atomic<bool> timedOut{false};
+    atomic<bool> gaveUp{false};
+    atomic<size_t> numPassed{0};
+    atomic<uint64_t> numDiscarded{0};
+    const uint64_t maxDiscards = static_cast<uint64_t>(maxDiscardRatio.value_or(defaultMaxDiscardRatio)) * effectiveNumRuns;
+    auto startedTime = steady_clock::now();
+
+    // run stats of the calling thread, if collected; workers collect their own and add them to it
+    RunStats* totalStats = getRunStats();
+
+    auto worker = [&](uint32_t workerIndex) {
+        // each worker draws from its own stream, derived deterministically from the seed
+        Random rand(util::deriveSeed(effectiveSeed, workerIndex), effectiveEngine);
+        Random savedRand(rand);
+        PropertyContext ctx;
+        RunStats workerStats;
+        RunStatsBinding statsBinding(totalStats ? &workerStats : nullptr);
+        util::DiscardStats discardStats;
+        discardStats.maxFilterAttempts = maxFilterAttempts.value_or(util::kDefaultMaxFilterAttempts);
+        util::DiscardStatsBinding discardBinding(&discardStats);
+        const uint32_t budget =
+            effectiveNumRuns / effectiveNumThreads + (workerIndex < effectiveNumRuns % effectiveNumThreads ? 1 : 0);
+
+        bool failed = false;
+        uint64_t runIndex = workerIndex;
+        auto reportFailure = [&](const string& detail) {
+            failed = true;
+            failures[workerIndex].emplace(WorkerFailure{savedRand, detail, runIndex});
+            uint64_t current = failureIndex.load();
+            while (runIndex < current && !failureIndex.compare_exchange_weak(current, runIndex)) {
+            }
+        };
+
+        try {
+            for (uint32_t i = 0; i < budget && !stop; i++) {
+                runIndex = static_cast<uint64_t>(i) * effectiveNumThreads + workerIndex;
+                if (runIndex > failureIndex.load())
+                    break;
+                if (effectiveMaxDurationMs != 0 &&
+                    duration_cast<util::milliseconds>(steady_clock::now() - startedTime).count() > effectiveMaxDurationMs) {
+                    timedOut = true;
+                    stop = true;
+                    break;
+                }
+                if (effectiveGrowSize)
+                    rand.setSizeFactor(static_cast<double>(i + 1) / budget);
+                bool pass = true;
+                do {
+                    pass = true;
+                    try {
+                        savedRand = rand;
+                        if (onStartup) {
+                            util::PhaseTimer timer(getPhaseStats(&RunStats::startup));
+                            onStartup();
+                        }
+                        bool result = callFunctionFromGen(rand, curGenVec);
+                        if (onCleanup) {
+                            util::PhaseTimer timer(getPhaseStats(&RunStats::cleanup));
+                            onCleanup();
+                        }
+                        stringstream failures = ctx.flushFailures();
+                        if (failures.rdbuf()->in_avail()) {
+                            reportFailure(": " + failures.str());
+                            break;
+                        } else if (!result) {
+                            reportFailure("\n");
+                            break;
+                        }
+                    } catch (const Success&) {
+                        pass = true;
+                    } catch (const Discard&) {
+                        pass = false;
+                        discardStats.numDiscarded++;
+                        if (++numDiscarded > maxDiscards && maxDiscards != 0) {
+                            gaveUp = true;
+                            stop = true;
+                            break;
+                        }
+                    }
+                } while (!pass && !stop);
+                if (failed || !pass)
+                    break;
+                numPassed++;
+            }
+        } catch (const AssertFailed& e) {
+            reportFailure(string(": ") + e.what() + " (" + e.filename + ":" + to_string(e.lineno) + ")\n");
+        } catch (const PropertyFailedBase& e) {
+            reportFailure(string(": ") + e.what() + " (" + e.filename + ":" + to_string(e.lineno) + ")\n");
+        } catch (const exception& e) {
+            reportFailure(string(" - unhandled exception thrown: ") + e.what() + "\n");
+        }
+
+        lock_guard<mutex> guard(mtx);
+        total.merge(ctx);
+        totalDiscards.merge(discardStats);
+        if (totalStats)
+            totalStats->merge(workerStats);
+    };
+
+    vector<thread> workers;
+    workers.reserve(effectiveNumThreads);
+    for (uint32_t t = 0; t < effectiveNumThreads; t++)
+        workers.emplace_back(worker, t);
+    for (auto& w : workers)
+        w.join();
+
+    WorkerFailure* firstFailure = nullptr;
+    for (auto& failure : failures) {
+        if (failure && (!firstFailure || failure->runIndex < firstFailure->runIndex))
+            firstFailure = &*failure;
+    }
+    if (firstFailure) {
+        *errorStream << "Falsifiable, after " << (firstFailure->runIndex + 1) << " tests" << firstFailure->detail;
+        shrink(firstFailure->savedRand, curGenVec);
+        return false;
+    }
+
+    if (gaveUp) {
+        *errorStream << "Gave up after " << numPassed << " tests: " << totalDiscards.numDiscarded
+                     << " runs discarded" << endl;
+        reportDiscards(totalDiscards, numPassed);
+        return false;
+    }
+
+    if (timedOut)
+        *outputStream << "Timed out after "
+                      << duration_cast<util::milliseconds>(steady_clock::now() - startedTime).count()
+                      << "ms, passed " << numPassed << " tests" << endl;
+    else
+        *outputStream << "OK, passed " << effectiveNumRuns << " tests" << endl;
+    return finishRun(total, numPassed, totalDiscards);
+}
+
 bool PropertyBase::test(const vector<ShrinkableBase>& curShrVec)
 {
     bool result = false;
@@ -323,8 +643,23 @@ pair<bool, string> PropertyBase::shrinkTestCandidate(const vector<ShrinkableBase
     return {false, ""};
 }
 
+string PropertyBase::shrinkCacheKey(const vector<ShrinkableBase>& curShrVec) const
+{
+    if (shrinkCacheHash)
+        return to_string(shrinkCacheHash(curShrVec));
+    // the text itself, not its hash, so that candidates printed differently are never confused
+    stringstream str;
+    writeArgs(str, curShrVec);
+    return str.str();
+}
+
 void PropertyBase::shrink(Random& savedRand, const GenVec& curGenVec)
 {
+    util::PhaseTimer shrinkTimer(getPhaseStats(&RunStats::shrink));
+    RunStats* stats = getRunStats();
+    // shrink tree nodes created below are short-lived; draw them from a session arena
+    util::ShrinkArenaScope arenaScope;
+
     // Regenerate failed value tuple from saved seed
     const size_t Arity = curGenVec.size();
     vector<ShrinkableBase> shrVec;
@@ -342,8 +677,19 @@ void PropertyBase::shrink(Random& savedRand, const GenVec& curGenVec)
     const uint32_t effectiveShrinkMaxRetries = shrinkMaxRetries.value_or(0);
     const uint32_t effectiveShrinkTimeoutMs = shrinkTimeoutMs.value_or(0);
     const bool useRetry = (effectiveShrinkMaxRetries > 0);
+    const size_t batchSize = shrinkNumThreads.value_or(1) > 1 ? shrinkNumThreads.value() : 1;
+    const bool useCache = shrinkCache.value_or(false);
     int64_t candidateTimeoutMs = 0;
     auto shrinkPhaseStart = steady_clock::now();
+
+    // keys of candidates that passed; shrink streams often yield the same args more than once
+    unordered_set<string> passedCandidates;
+    size_t numCacheHits = 0;
+
+    // candidates are tested in batches of batchSize on the pool; the shrink stream itself is only walked here
+    unique_ptr<util::ThreadPool> pool;
+    if (batchSize > 1)
+        pool = util::make_unique<util::ThreadPool>(batchSize);
     int assessmentIndex = 0;
     bool anyShrinkFound = false;
 
@@ -363,21 +709,51 @@ void PropertyBase::shrink(Random& savedRand, const GenVec& curGenVec)
             auto iter = shrinks.iterator<ShrinkableBase::StreamElementType>();
             bool shrinkFound = false;
             string failureMsg;
-            while (iter.hasNext()) {
-                auto next = iter.next();
-                vector<ShrinkableBase> curShrVec = shrVec;
-                curShrVec[i] = next;
-
-                auto [failed, msg] = shrinkTestCandidate(curShrVec, useRetry, effectiveShrinkMaxRetries,
-                    effectiveShrinkTimeoutMs, candidateTimeoutMs, shrinkPhaseStart);
-                if (failed)
-                    failureMsg = msg;
-
-                if (failed) {
-                    shrinks = next.getShrinks();
-                    shrVec[i] = next;
-                    shrinkFound = true;
-                    break;
+            while (iter.hasNext() && !shrinkFound) {
+                vector<ShrinkableBase> batch;
+                vector<string> batchKeys;
+                while (iter.hasNext() && batch.size() < batchSize) {
+                    auto next = iter.next();
+                    if (useCache) {
+                        vector<ShrinkableBase> curShrVec = shrVec;
+                        curShrVec[i] = next;
+                        string key = shrinkCacheKey(curShrVec);
+                        if (passedCandidates.count(key)) {
+                            numCacheHits++;
+                            continue;
+                        }
+                        batchKeys.push_back(util::move(key));
+                    }
+                    batch.push_back(next);
+                }
+                if (batch.empty())
+                    continue;
+                if (stats)
+                    stats->numShrinkCandidates += batch.size();
+
+                vector<pair<bool, string>> results(batch.size());
+                auto testCandidate = [&](size_t k) {
+                    vector<ShrinkableBase> curShrVec = shrVec;
+                    curShrVec[i] = batch[k];
+                    results[k] = shrinkTestCandidate(curShrVec, useRetry, effectiveShrinkMaxRetries,
+                        effectiveShrinkTimeoutMs, candidateTimeoutMs, shrinkPhaseStart);
+                };
+                if (pool)
+                    pool->parallelFor(batch.size(), testCandidate);
+                else
+                    testCandidate(0);
+
+                // the first failing candidate in stream order wins, as in a sequential shrink
+                for (size_t k = 0; k < batch.size(); k++) {
+                    if (!results[k].first) {
+                        if (useCache)
+                            passedCandidates.insert(util::move(batchKeys[k]));
+                    } else if (!shrinkFound) {
+                        failureMsg = results[k].second;
+                        shrinks = batch[k].getShrinks();
+                        shrVec[i] = batch[k];
+                        shrinkFound = true;
+                    }
                 }
             }
             if (shrinkFound) {
@@ -393,6 +769,8 @@ void PropertyBase::shrink(Random& savedRand, const GenVec& curGenVec)
         }
     }
 
+    if (numCacheHits > 0)
+        *outputStream << "  shrink cache skipped " << numCacheHits << " already passed candidate(s)" << endl;
     if (anyShrinkFound)
         *outputStream << "  simplest args found by shrinking: " << ShowShrVec{*this, shrVec} << endl;
 }
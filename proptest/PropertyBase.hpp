@@ -2,72 +2,72 @@
 
 #include "proptest/api.hpp"
 #include "proptest/PropertyContext.hpp"
+#include "proptest/RunStats.hpp"
 #include "proptest/std/chrono.hpp"
 #include "proptest/std/io.hpp"
 #include "proptest/std/optional.hpp"
 #include "proptest/std/pair.hpp"
+#include "proptest/std/type.hpp"
 #include "proptest/std/vector.hpp"
+#include "proptest/util/discard_stats.hpp"
 #include "proptest/util/function.hpp"
 #include "proptest/Generator.hpp"
 
+// the message is formatted and the context is reached only when the expectation fails
 #define PROP_EXPECT_STREAM(condition, displayCondition, a, sign, b)                          \
-    ([&]() -> stringstream& {                                                           \
-        if (!(condition)) {                                                                  \
-            stringstream __prop_expect_stream_str;                                      \
-            __prop_expect_stream_str << (a) << (sign) << (b);                                      \
-            ::proptest::PropertyBase::fail(__FILE__, __LINE__, (displayCondition), __prop_expect_stream_str);    \
-        } else {                                                                             \
-            stringstream __prop_expect_stream_str;                                      \
-            ::proptest::PropertyBase::succeed(__FILE__, __LINE__, (displayCondition), __prop_expect_stream_str); \
-        }                                                                                    \
-        return ::proptest::PropertyBase::getLastStream();                                                \
+    ([&]() -> ::proptest::ExpectStream {                                                     \
+        if ((condition)) [[likely]]                                                          \
+            return ::proptest::ExpectStream();                                               \
+        stringstream __prop_expect_stream_str;                                               \
+        __prop_expect_stream_str << (a) << (sign) << (b);                                    \
+        return ::proptest::PropertyBase::fail(__FILE__, __LINE__, (displayCondition), __prop_expect_stream_str); \
     })()
 
 #define PROP_EXPECT(cond) PROP_EXPECT_STREAM(cond, #cond, "", "", "")
 #define PROP_EXPECT_TRUE(cond) PROP_EXPECT_STREAM(cond, #cond, "", "", "")
 #define PROP_EXPECT_FALSE(cond)                                                                             \
-    ([&]() -> stringstream& {                                                                               \
+    ([&]() -> ::proptest::ExpectStream {                                                                               \
         const auto& __prop_cond = (cond);                                                                          \
         return PROP_EXPECT_STREAM(!__prop_cond, #cond " == false", __prop_cond, " == ", "true");               \
     })()
 #define PROP_EXPECT_EQ(a, b)                                                                                \
-    ([&]() -> stringstream& {                                                                               \
+    ([&]() -> ::proptest::ExpectStream {                                                                               \
         const auto& __prop_a = (a);                                                                                \
         const auto& __prop_b = (b);                                                                                \
         return PROP_EXPECT_STREAM((__prop_a == __prop_b), #a " == " #b, __prop_a, " != ", __prop_b);           \
     })()
 #define PROP_EXPECT_NE(a, b)                                                                                \
-    ([&]() -> stringstream& {                                                                               \
+    ([&]() -> ::proptest::ExpectStream {                                                                               \
         const auto& __prop_a = (a);                                                                                \
         const auto& __prop_b = (b);                                                                                \
         return PROP_EXPECT_STREAM((__prop_a != __prop_b), #a " != " #b, __prop_a, " == ", __prop_b);           \
     })()
 #define PROP_EXPECT_LT(a, b)                                                                                \
-    ([&]() -> stringstream& {                                                                               \
+    ([&]() -> ::proptest::ExpectStream {                                                                               \
         const auto& __prop_a = (a);                                                                                \
         const auto& __prop_b = (b);                                                                                \
         return PROP_EXPECT_STREAM((__prop_a < __prop_b), #a " < " #b, __prop_a, " >= ", __prop_b);              \
     })()
 #define PROP_EXPECT_GT(a, b)                                                                                \
-    ([&]() -> stringstream& {                                                                               \
+    ([&]() -> ::proptest::ExpectStream {                                                                               \
         const auto& __prop_a = (a);                                                                                \
         const auto& __prop_b = (b);                                                                                \
         return PROP_EXPECT_STREAM((__prop_a > __prop_b), #a " > " #b, __prop_a, " <= ", __prop_b);              \
     })()
 #define PROP_EXPECT_LE(a, b)                                                                                \
-    ([&]() -> stringstream& {                                                                               \
+    ([&]() -> ::proptest::ExpectStream {                                                                               \
         const auto& __prop_a = (a);                                                                                \
         const auto& __prop_b = (b);                                                                                \
         return PROP_EXPECT_STREAM((__prop_a <= __prop_b), #a " <= " #b, __prop_a, " > ", __prop_b);              \
     })()
 #define PROP_EXPECT_GE(a, b)                                                                                \
-    ([&]() -> stringstream& {                                                                               \
+    ([&]() -> ::proptest::ExpectStream {                                                                               \
         const auto& __prop_a = (a);                                                                                \
         const auto& __prop_b = (b);                                                                                \
         return PROP_EXPECT_STREAM((__prop_a >= __prop_b), #a " >= " #b, __prop_a, " < ", __prop_b);              \
     })()
 #define PROP_EXPECT_STREQ(a, b, n)                                                                          \
-    ([&]() -> stringstream& {                                                                               \
+    ([&]() -> ::proptest::ExpectStream {                                                                               \
         const auto& __prop_a = (a);                                                                                \
         const auto& __prop_b = (b);                                                                                \
         const auto& __prop_n = (n);                                                                                \
@@ -76,7 +76,7 @@
                                  ::proptest::Show<char*>(__prop_b, __prop_n));                              \
     })()
 #define PROP_EXPECT_STREQ2(a, b, n1, n2)                                                                    \
-    ([&]() -> stringstream& {                                                                               \
+    ([&]() -> ::proptest::ExpectStream {                                                                               \
         const auto& __prop_a = (a);                                                                                \
         const auto& __prop_b = (b);                                                                                \
         const auto& __prop_n1 = (n1);                                                                              \
@@ -86,7 +86,7 @@
                                  ::proptest::Show<char*>(__prop_b, __prop_n2));                              \
     })()
 #define PROP_EXPECT_STRNE(a, b, n)                                                                          \
-    ([&]() -> stringstream& {                                                                               \
+    ([&]() -> ::proptest::ExpectStream {                                                                               \
         const auto& __prop_a = (a);                                                                                \
         const auto& __prop_b = (b);                                                                                \
         const auto& __prop_n = (n);                                                                                \
@@ -95,7 +95,7 @@
                                  ::proptest::Show<char*>(__prop_b, __prop_n));                               \
     })()
 #define PROP_EXPECT_STRNE2(a, b, n1, n2)                                                                    \
-    ([&]() -> stringstream& {                                                                               \
+    ([&]() -> ::proptest::ExpectStream {                                                                               \
         const auto& __prop_a = (a);                                                                                \
         const auto& __prop_b = (b);                                                                                \
         const auto& __prop_n1 = (n1);                                                                              \
@@ -105,24 +105,14 @@
                                  ::proptest::Show<char*>(__prop_b, __prop_n2));                               \
     })()
 
-#define PROP_STAT(VALUE)                                                                       \
-    do {                                                                                       \
-        stringstream __prop_stat_key;                                                     \
-        __prop_stat_key << (#VALUE);                                                           \
-        stringstream __prop_stat_value;                                                   \
-        __prop_stat_value << boolalpha;                                                   \
-        __prop_stat_value << (VALUE);                                                          \
-        ::proptest::PropertyBase::tag(__FILE__, __LINE__, __prop_stat_key.str(), __prop_stat_value.str()); \
+#define PROP_STAT(VALUE)                                                        \
+    do {                                                                        \
+        ::proptest::PropertyBase::tagValue(__FILE__, __LINE__, #VALUE, (VALUE)); \
     } while (false)
 
-#define PROP_TAG(KEY, VALUE)                                                                   \
-    do {                                                                                       \
-        stringstream __prop_stat_key;                                                     \
-        __prop_stat_key << (KEY);                                                              \
-        stringstream __prop_stat_value;                                                   \
-        __prop_stat_value << boolalpha;                                                   \
-        __prop_stat_value << (VALUE);                                                          \
-        ::proptest::PropertyBase::tag(__FILE__, __LINE__, __prop_stat_key.str(), __prop_stat_value.str()); \
+#define PROP_TAG(KEY, VALUE)                                                    \
+    do {                                                                        \
+        ::proptest::PropertyBase::tagValue(__FILE__, __LINE__, (KEY), (VALUE)); \
     } while (false)
 
 #define PROP_CLASSIFY(condition, KEY, VALUE)                   \
@@ -132,30 +122,90 @@
         }                                                      \
     } while (false)
 
+#define PROP_STAT_NUM(VALUE)                                                                                 \
+    do {                                                                                                     \
+        ::proptest::PropertyBase::tagNumeric(__FILE__, __LINE__, #VALUE, static_cast<double>(VALUE));        \
+    } while (false)
+
 #define PROP_STAT_ASSERT_GE(EXPR, BOUND)                                                       \
     do {                                                                                       \
         PROP_STAT(EXPR);                                                                       \
-        stringstream __prop_stat_assert_key; __prop_stat_assert_key << (#EXPR);                 \
-        ::proptest::PropertyBase::addStatAssertGe(__prop_stat_assert_key.str(), static_cast<double>(BOUND), __FILE__, __LINE__); \
+        ::proptest::PropertyBase::addStatAssertGe(#EXPR, static_cast<double>(BOUND), __FILE__, __LINE__); \
     } while (false)
 
 #define PROP_STAT_ASSERT_LE(EXPR, BOUND)                                                       \
     do {                                                                                       \
         PROP_STAT(EXPR);                                                                       \
-        stringstream __prop_stat_assert_key; __prop_stat_assert_key << (#EXPR);                 \
-        ::proptest::PropertyBase::addStatAssertLe(__prop_stat_assert_key.str(), static_cast<double>(BOUND), __FILE__, __LINE__); \
+        ::proptest::PropertyBase::addStatAssertLe(#EXPR, static_cast<double>(BOUND), __FILE__, __LINE__); \
     } while (false)
 
 #define PROP_STAT_ASSERT_IN_RANGE(EXPR, MIN_BOUND, MAX_BOUND)                                  \
     do {                                                                                       \
         PROP_STAT(EXPR);                                                                       \
-        stringstream __prop_stat_assert_key; __prop_stat_assert_key << (#EXPR);                 \
-        ::proptest::PropertyBase::addStatAssertInRange(__prop_stat_assert_key.str(),            \
+        ::proptest::PropertyBase::addStatAssertInRange(#EXPR,                                   \
             static_cast<double>(MIN_BOUND), static_cast<double>(MAX_BOUND), __FILE__, __LINE__); \
     } while (false)
 
+// MEASURE is one of MEAN, STDDEV, MIN, MAX, P50, P90, P99
+#define PROP_STAT_NUM_ASSERT_GE(EXPR, MEASURE, BOUND)                                                        \
+    do {                                                                                                     \
+        PROP_STAT_NUM(EXPR);                                                                                 \
+        ::proptest::PropertyBase::addStatAssertGe(#EXPR, static_cast<double>(BOUND), __FILE__, __LINE__,     \
+                                                  ::proptest::StatMeasure::MEASURE);                         \
+    } while (false)
+
+#define PROP_STAT_NUM_ASSERT_LE(EXPR, MEASURE, BOUND)                                                        \
+    do {                                                                                                     \
+        PROP_STAT_NUM(EXPR);                                                                                 \
+        ::proptest::PropertyBase::addStatAssertLe(#EXPR, static_cast<double>(BOUND), __FILE__, __LINE__,     \
+                                                  ::proptest::StatMeasure::MEASURE);                         \
+    } while (false)
+
+#define PROP_STAT_NUM_ASSERT_IN_RANGE(EXPR, MEASURE, MIN_BOUND, MAX_BOUND)                                   \
+    do {                                                                                                     \
+        PROP_STAT_NUM(EXPR);                                                                                 \
+        ::proptest::PropertyBase::addStatAssertInRange(#EXPR, static_cast<double>(MIN_BOUND),                \
+            static_cast<double>(MAX_BOUND), __FILE__, __LINE__, ::proptest::StatMeasure::MEASURE);           \
+    } while (false)
+
 namespace proptest {
 
+/**
+ * @brief Result of PROP_EXPECT and its variants
+ *
+ * Streaming into it appends to the failure message of a failed expectation, and does nothing for a passing one:
+ * @code
+ * PROP_EXPECT_EQ(a, b) << "after " << n << " steps";
+ * @endcode
+ */
+class ExpectStream
+{
+public:
+    ExpectStream() : str(nullptr) {}
+    explicit ExpectStream(stringstream& failureStr) : str(&failureStr) {}
+
+    template <typename T>
+    ExpectStream& operator<<(const T& value)
+    {
+        if (str) [[unlikely]]
+            *str << value;
+        return *this;
+    }
+
+    ExpectStream& operator<<(ostream& (*manip)(ostream&))
+    {
+        if (str) [[unlikely]]
+            *str << manip;
+        return *this;
+    }
+
+    /// Whether the expectation failed
+    bool failed() const { return str != nullptr; }
+
+private:
+    stringstream* str;
+};
+
 /// Stats from a shrink assessment (reproduction rate measurement)
 struct PROPTEST_API ReproductionStats {
     int numReproduced = 0;   // n in "reproduction: n/T"
@@ -182,11 +232,46 @@ public:
 
     static void setDefaultNumRuns(uint32_t);
     static void tag(const char* filename, int lineno, string key, string value);
-    static void addStatAssertGe(string&& key, double bound, const char* filename, int lineno);
-    static void addStatAssertLe(string&& key, double bound, const char* filename, int lineno);
-    static void addStatAssertInRange(string&& key, double minBound, double maxBound, const char* filename, int lineno);
+    static void tagBool(const char* filename, int lineno, string_view key, bool value);
+    static void tagInt(const char* filename, int lineno, string_view key, int64_t value);
+    static void tagUInt(const char* filename, int lineno, string_view key, uint64_t value);
+
+    /**
+     * @brief Records a value of a tag key for PROP_STAT and PROP_TAG
+     *
+     * Bool and integer values are counted as numbers; other values (including characters) are counted by their
+     * streamed text.
+     */
+    template <typename K, typename V>
+    static void tagValue(const char* filename, int lineno, const K& key, const V& value)
+    {
+        if constexpr (!is_convertible_v<const K&, string_view>) {
+            stringstream keyStr;
+            keyStr << key;
+            tagValue(filename, lineno, keyStr.str(), value);
+        } else if constexpr (is_same_v<V, bool>) {
+            tagBool(filename, lineno, key, value);
+        } else if constexpr (is_integral_v<V> && sizeof(V) > 1 && is_signed_v<V>) {
+            tagInt(filename, lineno, key, static_cast<int64_t>(value));
+        } else if constexpr (is_integral_v<V> && sizeof(V) > 1) {
+            tagUInt(filename, lineno, key, static_cast<uint64_t>(value));
+        } else {
+            stringstream valueStr;
+            valueStr << boolalpha << value;
+            tag(filename, lineno, string(string_view(key)), valueStr.str());
+        }
+    }
+
+    static void tagNumeric(const char* filename, int lineno, string_view key, double value);
+    static void addStatAssertGe(string&& key, double bound, const char* filename, int lineno,
+                                StatMeasure measure = StatMeasure::TRUE_RATIO);
+    static void addStatAssertLe(string&& key, double bound, const char* filename, int lineno,
+                                StatMeasure measure = StatMeasure::TRUE_RATIO);
+    static void addStatAssertInRange(string&& key, double minBound, double maxBound, const char* filename, int lineno,
+                                     StatMeasure measure = StatMeasure::TRUE_RATIO);
     static void succeed(const char* filename, int lineno, const char* condition, const stringstream& str);
-    static void fail(const char* filename, int lineno, const char* condition, const stringstream& str);
+    /// Records a failed expectation; the returned stream appends to its message
+    static ExpectStream fail(const char* filename, int lineno, const char* condition, const stringstream& str);
     static stringstream& getLastStream();
 
     virtual void writeArgs(ostream& os, const vector<ShrinkableBase>& shrVec) const = 0;
@@ -200,6 +285,13 @@ public:
 
     /// Last reproduction stats (only when shrinkMaxRetries > 0 and failure triggered shrink).
     optional<ReproductionStats> getLastReproductionStats() const { return lastReproductionStats; }
+    /// Phase breakdown of the last forAll run (only when run stats are collected)
+    optional<RunStats> getLastRunStats() const { return lastRunStats; }
+    PropertyBase& setOnRunStats(Function<void(RunStats)> f)
+    {
+        onRunStats = util::move(f);
+        return *this;
+    }
     PropertyBase& setOnReproductionStats(Function<void(ReproductionStats)> f)
     {
         onReproductionStats = util::move(f);
@@ -252,31 +344,61 @@ public:
     };
 
 protected:
+    // the active context is tracked per thread, so that parallel workers can each own one
     static void setContext(PropertyContext* context);
-    static PropertyContext* getContext() { return context; }
-    static PropertyContext* context;
+    static PropertyContext* getContext();
+    /// Stats of the run on the calling thread, or nullptr when they are not collected
+    static RunStats* getRunStats();
+    /// Phase of the current run's stats to time, or nullptr when they are not collected
+    static PhaseStats* getPhaseStats(PhaseStats RunStats::*phase)
+    {
+        RunStats* stats = getRunStats();
+        return stats ? &(stats->*phase) : nullptr;
+    }
 
 protected:
     bool invoke(Random& rand);
+    bool runForAllImpl(const GenVec& curGenVec);
+    bool runForAllParallel(const GenVec& curGenVec, uint64_t effectiveSeed, RandomEngine effectiveEngine,
+        uint32_t effectiveNumRuns, uint32_t effectiveMaxDurationMs, uint32_t effectiveNumThreads,
+        bool effectiveGrowSize);
+    /// Checks stat assertions and prints the discard and tag summaries at the end of a run
+    bool finishRun(PropertyContext& ctx, size_t numPassed, const util::DiscardStats& discardStats);
+    /// Prints discarded runs and filter acceptance rates, with a warning for those below minAcceptanceRate
+    void reportDiscards(const util::DiscardStats& discardStats, size_t numPassed) const;
     virtual bool callFunction(const vector<Any>& anyVec) = 0;
     virtual bool callFunction(const vector<ShrinkableBase>& shrVec) = 0;
     virtual bool callFunctionFromGen(Random& rand, const vector<AnyGenerator>& genVec) = 0;
 
     static uint32_t defaultNumRuns;
     static uint32_t defaultMaxDurationMs;
+    static constexpr uint32_t defaultMaxDiscardRatio = 10;
+    static constexpr double defaultMinAcceptanceRate = 0.1;
 
     // Config: optional = use default at runtime; avoids sentinel-value bugs (e.g. UINT64_MAX as valid seed)
     optional<uint64_t> seed = nullopt;
+    optional<RandomEngine> randomEngine = nullopt;   // default: util::getGlobalRandomEngine()
     optional<uint32_t> numRuns = nullopt;
     optional<uint32_t> maxDurationMs = nullopt;
+    optional<uint32_t> timeBudgetMs = nullopt;       // default: share of util::TimeBudget::global(), if active
+    optional<bool> growSize = nullopt;               // default false = containers sized up to maxSize from the first run
+    optional<uint32_t> numThreads = nullopt;         // default 1 = run on the calling thread
+    optional<uint32_t> maxFilterAttempts = nullopt;  // default util::kDefaultMaxFilterAttempts, 0 = no limit
+    optional<uint32_t> maxDiscardRatio = nullopt;    // default 10 discarded runs per run, 0 = no limit
+    optional<double> minAcceptanceRate = nullopt;    // default 0.1, 0 = no warnings
     optional<uint32_t> shrinkMaxRetries = nullopt;   // max retries; total trials = 1 + n. 0 = deterministic
     optional<uint32_t> shrinkTimeoutMs = nullopt;    // default 0 = no limit
     optional<uint32_t> shrinkRetryTimeoutMs = nullopt;  // default 0 = no limit
+    optional<uint32_t> shrinkNumThreads = nullopt;   // default 1 = test shrink candidates one at a time
+    optional<bool> shrinkCache = nullopt;            // default false = test every candidate
+    optional<bool> collectRunStats = nullopt;        // default false; true also prints them after the run
+    Function<size_t(const vector<ShrinkableBase>&)> shrinkCacheHash;  // default: hash of the printed args
 
     Function<void()> onStartup;
     Function<void()> onCleanup;
 
     Function<void(ReproductionStats)> onReproductionStats;
+    Function<void(RunStats)> onRunStats;  // setting it also collects run stats
     Function<void(int, const vector<Any>&, const string&)> onFailureReproduction;
     ostream* outputStream = &cout;
     ostream* errorStream = &cerr;
@@ -284,6 +406,7 @@ protected:
     vector<AnyGenerator> genVec;
 
     optional<ReproductionStats> lastReproductionStats;
+    optional<RunStats> lastRunStats;
 
     /// Last test run result (true = success, false = failure). Used for operator bool() and chainable API.
     bool lastRunOk = true;
@@ -294,12 +417,15 @@ protected:
     pair<bool, string> shrinkTestCandidate(const vector<ShrinkableBase>& curShrVec, bool useRetry,
         uint32_t maxRetries, uint32_t phaseTimeoutMs, int64_t candidateTimeoutMs,
         steady_clock::time_point phaseStart) const;
+    /// Key of a shrink candidate in the cache of passing candidates: its printed args, or the custom hash
+    string shrinkCacheKey(const vector<ShrinkableBase>& curShrVec) const;
     /// Run assessment (measure reproduction rate), print reproduction, update candidateTimeoutMs
     /// assessmentIndex: 0 = initial failure, 1 = first successful shrink, etc.
     void assessFailureForRetry(vector<ShrinkableBase>& shrVec, int64_t& candidateTimeoutMs,
         int assessmentIndex);
 
     friend struct PropertyContext;
+    friend class PropertyContextBinding;
 };
 
 }  // namespace proptest
@@ -1,6 +1,7 @@
 #include "proptest/PropertyContext.hpp"
 #include "proptest/PropertyBase.hpp"
 #include "proptest/std/pair.hpp"
+#include "proptest/std/math.hpp"
 
 namespace proptest {
 
@@ -14,7 +15,21 @@ ostream& operator<<(ostream& os, const Failure& f)
     return os;
 }
 
-PropertyContext::PropertyContext() : lastStreamExists(false), oldContext(PropertyBase::getContext())
+namespace {
+
+// stream of the expectation last recorded by the calling thread, for appending details via PROP_EXPECT(...) << ...
+struct LastStream
+{
+    const PropertyContext* owner = nullptr;
+    stringstream* stream = nullptr;
+    size_t flushCount = 0;
+};
+
+thread_local LastStream lastStream;
+
+}  // namespace
+
+PropertyContext::PropertyContext() : flushCount(0), oldContext(PropertyBase::getContext())
 {
     PropertyBase::setContext(this);
 }
@@ -24,52 +39,323 @@ PropertyContext::~PropertyContext()
     PropertyBase::setContext(oldContext);
 }
 
-void PropertyContext::tag(const char* file, int lineno, string key, string value)
+PropertyContext* PropertyContext::current()
+{
+    return PropertyBase::getContext();
+}
+
+PropertyContextBinding::PropertyContextBinding(PropertyContext* context) : oldContext(PropertyBase::getContext())
+{
+    PropertyBase::setContext(context);
+}
+
+PropertyContextBinding::~PropertyContextBinding()
+{
+    PropertyBase::setContext(oldContext);
+}
+
+const char* statMeasureName(StatMeasure measure)
+{
+    switch (measure) {
+        case StatMeasure::TRUE_RATIO:
+            return "TRUE_RATIO";
+        case StatMeasure::MEAN:
+            return "MEAN";
+        case StatMeasure::STDDEV:
+            return "STDDEV";
+        case StatMeasure::MIN:
+            return "MIN";
+        case StatMeasure::MAX:
+            return "MAX";
+        case StatMeasure::P50:
+            return "P50";
+        case StatMeasure::P90:
+            return "P90";
+        case StatMeasure::P99:
+            return "P99";
+    }
+    return "?";
+}
+
+namespace {
+
+// bucket i holds magnitudes in (gamma^(i-1), gamma^i]; its midpoint is within 1% of any of them
+constexpr double kBucketGamma = 1.01 / 0.99;
+
+}  // namespace
+
+int32_t NumericStat::bucketIndex(double magnitude)
+{
+    static const double logGamma = log(kBucketGamma);
+    return static_cast<int32_t>(ceil(log(magnitude) / logGamma));
+}
+
+double NumericStat::bucketValue(int32_t index)
 {
-    auto itr = tags.find(key);
-    // key already exists
-    if (itr != tags.end()) {
-        auto& valueMap = itr->second;
-        auto valueItr = valueMap.find(value);
-        // value already exists
-        if (valueItr != valueMap.end()) {
-            auto& tag = valueItr->second;
-            tag.count++;
-        } else {
-            valueMap.insert(pair<string, Tag>(value, Tag(file, lineno, value)));
+    return 2.0 * pow(kBucketGamma, index) / (kBucketGamma + 1.0);
+}
+
+void NumericStat::addBucket(map<int32_t, size_t>& buckets, int32_t index, size_t n)
+{
+    buckets[index] += n;
+    // fold the smallest magnitudes together; the larger ones keep their accuracy
+    while (buckets.size() > kMaxBuckets) {
+        auto smallest = buckets.begin();
+        auto next = smallest;
+        ++next;
+        next->second += smallest->second;
+        buckets.erase(smallest);
+    }
+}
+
+void NumericStat::add(double value)
+{
+    if (!isfinite(value)) {
+        numNonFinite++;
+        return;
+    }
+
+    count++;
+    const double delta = value - mean;
+    mean += delta / static_cast<double>(count);
+    m2 += delta * (value - mean);
+    if (count == 1 || value < minValue)
+        minValue = value;
+    if (count == 1 || value > maxValue)
+        maxValue = value;
+
+    if (value > 0)
+        addBucket(positiveBuckets, bucketIndex(value), 1);
+    else if (value < 0)
+        addBucket(negativeBuckets, bucketIndex(-value), 1);
+    else
+        numZero++;
+}
+
+void NumericStat::merge(const NumericStat& other)
+{
+    numNonFinite += other.numNonFinite;
+    if (other.count == 0)
+        return;
+
+    if (count == 0) {
+        mean = other.mean;
+        m2 = other.m2;
+        minValue = other.minValue;
+        maxValue = other.maxValue;
+    } else {
+        // Chan et al.'s pairwise update of the mean and the sum of squares
+        const double n1 = static_cast<double>(count), n2 = static_cast<double>(other.count);
+        const double delta = other.mean - mean;
+        mean += delta * n2 / (n1 + n2);
+        m2 += other.m2 + delta * delta * n1 * n2 / (n1 + n2);
+        if (other.minValue < minValue)
+            minValue = other.minValue;
+        if (other.maxValue > maxValue)
+            maxValue = other.maxValue;
+    }
+    count += other.count;
+
+    numZero += other.numZero;
+    for (const auto& [index, n] : other.positiveBuckets)
+        addBucket(positiveBuckets, index, n);
+    for (const auto& [index, n] : other.negativeBuckets)
+        addBucket(negativeBuckets, index, n);
+}
+
+double NumericStat::getVariance() const
+{
+    return count > 0 ? m2 / static_cast<double>(count) : 0.0;
+}
+
+double NumericStat::getStdDev() const
+{
+    return sqrt(getVariance());
+}
+
+double NumericStat::getQuantile(double q) const
+{
+    if (count == 0)
+        return 0.0;
+    // the extremes are known exactly
+    if (q <= 0.0)
+        return minValue;
+    if (q >= 1.0)
+        return maxValue;
+
+    const double rank = q * static_cast<double>(count - 1);
+    double estimate = maxValue;
+    size_t seen = 0;
+    // walk the values in ascending order: negatives from the largest magnitude, then zeros, then positives
+    bool found = false;
+    for (auto itr = negativeBuckets.rbegin(); !found && itr != negativeBuckets.rend(); ++itr) {
+        seen += itr->second;
+        if (static_cast<double>(seen) > rank) {
+            estimate = -bucketValue(itr->first);
+            found = true;
+        }
+    }
+    if (!found) {
+        seen += numZero;
+        if (static_cast<double>(seen) > rank) {
+            estimate = 0.0;
+            found = true;
+        }
+    }
+    for (auto itr = positiveBuckets.begin(); !found && itr != positiveBuckets.end(); ++itr) {
+        seen += itr->second;
+        if (static_cast<double>(seen) > rank) {
+            estimate = bucketValue(itr->first);
+            found = true;
         }
+    }
+    return estimate < minValue ? minValue : estimate > maxValue ? maxValue : estimate;
+}
+
+optional<double> NumericStat::getMeasure(StatMeasure measure) const
+{
+    if (count == 0)
+        return nullopt;
+
+    switch (measure) {
+        case StatMeasure::TRUE_RATIO:
+            return nullopt;
+        case StatMeasure::MEAN:
+            return getMean();
+        case StatMeasure::STDDEV:
+            return getStdDev();
+        case StatMeasure::MIN:
+            return getMin();
+        case StatMeasure::MAX:
+            return getMax();
+        case StatMeasure::P50:
+            return getQuantile(0.5);
+        case StatMeasure::P90:
+            return getQuantile(0.9);
+        case StatMeasure::P99:
+            return getQuantile(0.99);
+    }
+    return nullopt;
+}
+
+size_t TagCounter::countTrue() const
+{
+    auto itr = stringCounts.find("true");
+    return numTrue + (itr != stringCounts.end() ? itr->second : 0);
+}
+
+void TagCounter::merge(const TagCounter& other)
+{
+    numTrue += other.numTrue;
+    numFalse += other.numFalse;
+    for (const auto& [value, count] : other.intCounts)
+        intCounts[value] += count;
+    for (const auto& [value, count] : other.uintCounts)
+        uintCounts[value] += count;
+    for (const auto& [value, count] : other.stringCounts)
+        stringCounts[value] += count;
+    numeric.merge(other.numeric);
+}
+
+map<string, size_t> TagCounter::countsByText() const
+{
+    // a value may have been recorded both as a number and as text; they show as one entry
+    map<string, size_t> counts;
+    if (numTrue > 0)
+        counts["true"] += numTrue;
+    if (numFalse > 0)
+        counts["false"] += numFalse;
+    for (const auto& [value, count] : intCounts)
+        counts[to_string(value)] += count;
+    for (const auto& [value, count] : uintCounts)
+        counts[to_string(value)] += count;
+    for (const auto& [value, count] : stringCounts)
+        counts[value] += count;
+    return counts;
+}
+
+TagCounter& PropertyContext::tagCounter(const char* filename, int lineno, string_view key)
+{
+    const TagSite site{filename, lineno};
+    auto siteItr = tagSites.find(site);
+    if (siteItr != tagSites.end() && tagCounters[siteItr->second].key == key)
+        return tagCounters[siteItr->second];
+
+    string keyStr(key);
+    auto indexItr = tagIndex.find(keyStr);
+    size_t index;
+    if (indexItr != tagIndex.end()) {
+        index = indexItr->second;
     } else {
-        map<string, Tag> valueMap;
-        valueMap.insert(pair<string, Tag>(value, Tag(file, lineno, value)));
-        tags.insert(pair<string, map<string, Tag>>(key, valueMap));
+        index = tagCounters.size();
+        tagCounters.emplace_back(keyStr);
+        tagIndex.emplace(util::move(keyStr), index);
     }
+    tagSites[site] = index;
+    return tagCounters[index];
+}
+
+void PropertyContext::tag(const char* file, int lineno, string key, string value)
+{
+    lock_guard<mutex> guard(mtx);
+    tagCounter(file, lineno, key).stringCounts[util::move(value)]++;
+}
+
+void PropertyContext::tagBool(const char* file, int lineno, string_view key, bool value)
+{
+    lock_guard<mutex> guard(mtx);
+    auto& counter = tagCounter(file, lineno, key);
+    if (value)
+        counter.numTrue++;
+    else
+        counter.numFalse++;
+}
+
+void PropertyContext::tagInt(const char* file, int lineno, string_view key, int64_t value)
+{
+    lock_guard<mutex> guard(mtx);
+    tagCounter(file, lineno, key).intCounts[value]++;
+}
+
+void PropertyContext::tagUInt(const char* file, int lineno, string_view key, uint64_t value)
+{
+    lock_guard<mutex> guard(mtx);
+    tagCounter(file, lineno, key).uintCounts[value]++;
+}
+
+void PropertyContext::tagNumeric(const char* file, int lineno, string_view key, double value)
+{
+    lock_guard<mutex> guard(mtx);
+    tagCounter(file, lineno, key).numeric.add(value);
 }
 
 void PropertyContext::succeed(const char*, int, const char*, const stringstream&)
 {
-    // DO NOTHING
-    lastStreamExists = false;
+    lastStream = LastStream{this, nullptr, 0};
 }
 
 void PropertyContext::fail(const char* filename, int lineno, const char* condition, const stringstream& str)
 {
+    lock_guard<mutex> guard(mtx);
     failures.push_back(Failure(filename, lineno, condition, str));
-    lastStreamExists = true;
+    lastStream = LastStream{this, &failures.back().str, flushCount};
 }
 
 void PropertyContext::fail(const char* filename, int lineno, string condition, const stringstream& str)
 {
+    lock_guard<mutex> guard(mtx);
     failures.push_back(Failure(filename, lineno, util::move(condition), str));
-    lastStreamExists = true;
+    lastStream = LastStream{this, &failures.back().str, flushCount};
 }
 
 stringstream& PropertyContext::getLastStream()
 {
-    static stringstream defaultStr;
-    if (failures.empty() || !lastStreamExists)
+    thread_local stringstream defaultStr;
+    lock_guard<mutex> guard(mtx);
+    if (lastStream.owner != this || !lastStream.stream || lastStream.flushCount != flushCount)
         return defaultStr;
 
-    return failures.back().str;
+    return *lastStream.stream;
 }
 
 stringstream PropertyContext::flushFailures(int indent)
@@ -79,6 +365,7 @@ stringstream PropertyContext::flushFailures(int indent)
             str << " ";
     };
 
+    lock_guard<mutex> guard(mtx);
     stringstream allFailures;
     auto itr = failures.begin();
     if (itr != failures.end()) {
@@ -91,50 +378,120 @@ stringstream PropertyContext::flushFailures(int indent)
         allFailures << *itr;
     }
     failures.clear();
+    flushCount++;
     return allFailures;
 }
 
-void PropertyContext::addStatAssertGe(string&& key, double minBound, const char* filename, int lineno)
+void PropertyContext::addStatAssertGe(string&& key, double minBound, const char* filename, int lineno,
+                                      StatMeasure measure)
 {
-    string dedupKey = "GE:" + key + ":" + to_string(minBound);
+    lock_guard<mutex> guard(mtx);
+    string dedupKey = "GE:" + string(statMeasureName(measure)) + ":" + key + ":" + to_string(minBound);
     if (statAssertKeys.find(dedupKey) != statAssertKeys.end())
         return;
     statAssertKeys.insert(dedupKey);
-    statAssertions.push_back(StatAssertion(util::move(key), StatAssertType::GE, minBound, filename, lineno));
+    statAssertions.push_back(StatAssertion(util::move(key), StatAssertType::GE, minBound, filename, lineno, 0.0, measure));
 }
 
-void PropertyContext::addStatAssertLe(string&& key, double maxBound, const char* filename, int lineno)
+void PropertyContext::addStatAssertLe(string&& key, double maxBound, const char* filename, int lineno,
+                                      StatMeasure measure)
 {
-    string dedupKey = "LE:" + key + ":" + to_string(maxBound);
+    lock_guard<mutex> guard(mtx);
+    string dedupKey = "LE:" + string(statMeasureName(measure)) + ":" + key + ":" + to_string(maxBound);
     if (statAssertKeys.find(dedupKey) != statAssertKeys.end())
         return;
     statAssertKeys.insert(dedupKey);
-    statAssertions.push_back(StatAssertion(util::move(key), StatAssertType::LE, maxBound, filename, lineno));
+    statAssertions.push_back(StatAssertion(util::move(key), StatAssertType::LE, maxBound, filename, lineno, 0.0, measure));
 }
 
-void PropertyContext::addStatAssertInRange(string&& key, double minBound, double maxBound, const char* filename, int lineno)
+void PropertyContext::addStatAssertInRange(string&& key, double minBound, double maxBound, const char* filename, int lineno,
+                                           StatMeasure measure)
 {
-    string dedupKey = "IN_RANGE:" + key + ":" + to_string(minBound) + ":" + to_string(maxBound);
+    lock_guard<mutex> guard(mtx);
+    string dedupKey = "IN_RANGE:" + string(statMeasureName(measure)) + ":" + key + ":" + to_string(minBound) + ":" +
+                      to_string(maxBound);
     if (statAssertKeys.find(dedupKey) != statAssertKeys.end())
         return;
     statAssertKeys.insert(dedupKey);
-    statAssertions.push_back(StatAssertion(util::move(key), StatAssertType::IN_RANGE, minBound, filename, lineno, maxBound));
+    statAssertions.push_back(
+        StatAssertion(util::move(key), StatAssertType::IN_RANGE, minBound, filename, lineno, maxBound, measure));
+}
+
+namespace {
+
+// PROP_STAT_NUM_ASSERT_*: bounds a measure of the aggregated values
+bool checkNumericStatAssertion(const StatAssertion& a, const TagCounter* counter, stringstream& ss)
+{
+    const optional<double> value = counter ? counter->numeric.getMeasure(a.measure) : nullopt;
+    const size_t count = counter ? counter->numeric.getCount() : 0;
+    const char* measureName = statMeasureName(a.measure);
+    bool pass = false;
+    if (value) {
+        switch (a.type) {
+            case StatAssertType::GE:
+                pass = *value >= a.bound1;
+                break;
+            case StatAssertType::LE:
+                pass = *value <= a.bound1;
+                break;
+            case StatAssertType::IN_RANGE:
+                pass = *value >= a.bound1 && *value <= a.bound2;
+                break;
+        }
+    }
+    if (pass)
+        return true;
+
+    switch (a.type) {
+        case StatAssertType::GE:
+            ss << "PROP_STAT_NUM_ASSERT_GE(" << a.key << ", " << measureName << ", " << a.bound1 << ") failed: ";
+            if (value)
+                ss << measureName << " " << *value << " < " << a.bound1;
+            break;
+        case StatAssertType::LE:
+            ss << "PROP_STAT_NUM_ASSERT_LE(" << a.key << ", " << measureName << ", " << a.bound1 << ") failed: ";
+            if (value)
+                ss << measureName << " " << *value << " > " << a.bound1;
+            break;
+        case StatAssertType::IN_RANGE:
+            ss << "PROP_STAT_NUM_ASSERT_IN_RANGE(" << a.key << ", " << measureName << ", " << a.bound1 << ", "
+               << a.bound2 << ") failed: ";
+            if (value)
+                ss << measureName << " " << *value << " not in [" << a.bound1 << ", " << a.bound2 << "]";
+            break;
+    }
+    if (value)
+        ss << " (" << count << " values)";
+    else
+        ss << "no finite values recorded";
+    return false;
 }
 
+}  // namespace
+
 bool PropertyContext::checkStatAssertions(size_t totalRuns)
 {
     if (totalRuns == 0)
         return true;
-    static const string kTrueValue("true");  // PROP_STAT records bool as "true"/"false"; we assert on "true" ratio
     bool allPassed = true;
     for (const auto& a : statAssertions) {
-        size_t count = 0;
-        auto keyItr = tags.find(a.key);
-        if (keyItr != tags.end()) {
-            auto valueItr = keyItr->second.find(kTrueValue);
-            if (valueItr != keyItr->second.end())
-                count = valueItr->second.count;
+        const TagCounter* counter = nullptr;
+        auto indexItr = tagIndex.find(a.key);
+        if (indexItr != tagIndex.end())
+            counter = &tagCounters[indexItr->second];
+
+        if (a.measure != StatMeasure::TRUE_RATIO) {
+            stringstream ss;
+            if (!checkNumericStatAssertion(a, counter, ss)) {
+                allPassed = false;
+                stringstream empty;
+                fail(a.filename, a.lineno, ss.str(), empty);
+            }
+            continue;
         }
+
+        // stat assertions are on the ratio of runs where the expression was true
+        const size_t count = counter ? counter->countTrue() : 0;
         double ratio = static_cast<double>(count) / totalRuns;
         bool pass = false;
         stringstream ss;
@@ -168,24 +525,68 @@ bool PropertyContext::checkStatAssertions(size_t totalRuns)
     return allPassed;
 }
 
+void PropertyContext::merge(const PropertyContext& other)
+{
+    vector<StatAssertion> otherStatAssertions;
+    {
+        scoped_lock guard(mtx, other.mtx);
+        for (const auto& otherCounter : other.tagCounters) {
+            auto indexItr = tagIndex.find(otherCounter.key);
+            if (indexItr != tagIndex.end()) {
+                tagCounters[indexItr->second].merge(otherCounter);
+            } else {
+                tagIndex.emplace(otherCounter.key, tagCounters.size());
+                tagCounters.push_back(otherCounter);
+            }
+        }
+        otherStatAssertions = other.statAssertions;
+    }
+
+    for (const auto& a : otherStatAssertions) {
+        string key = a.key;
+        switch (a.type) {
+            case StatAssertType::GE:
+                addStatAssertGe(util::move(key), a.bound1, a.filename, a.lineno, a.measure);
+                break;
+            case StatAssertType::LE:
+                addStatAssertLe(util::move(key), a.bound1, a.filename, a.lineno, a.measure);
+                break;
+            case StatAssertType::IN_RANGE:
+                addStatAssertInRange(util::move(key), a.bound1, a.bound2, a.filename, a.lineno, a.measure);
+                break;
+        }
+    }
+}
+
 void PropertyContext::printSummary(ostream& os)
 {
-    for (const auto& tagKV : tags) {
-        auto& key = tagKV.first;
-        auto& valueMap = tagKV.second;
+    // keys and values are listed in text order, independent of the order they were recorded in
+    map<string, const TagCounter*> sortedCounters;
+    for (const auto& counter : tagCounters)
+        sortedCounters.emplace(counter.key, &counter);
+
+    for (const auto& [key, counter] : sortedCounters) {
         os << "  " << key << ": " << endl;
+        const auto valueCounts = counter->countsByText();
         size_t total = 0;
-        for (const auto& valueKV : valueMap) {
-            auto tag = valueKV.second;
-            total += tag.count;
+        for (const auto& valueKV : valueCounts)
+            total += valueKV.second;
+
+        for (const auto& [value, count] : valueCounts) {
+            os << "    " << value << ": " << count << "/" << total << " ("
+               << static_cast<double>(count) / total * 100 << "%)" << endl;
         }
 
-        for (const auto& valueKV : valueMap) {
-            auto value = valueKV.first;
-            auto tag = valueKV.second;
-            os << "    " << value << ": " << tag.count << "/" << total << " ("
-               << static_cast<double>(tag.count) / total * 100 << "%)" << endl;
+        const NumericStat& numeric = counter->numeric;
+        if (numeric.getCount() > 0) {
+            os << "    count: " << numeric.getCount() << ", mean: " << numeric.getMean()
+               << ", stddev: " << numeric.getStdDev() << ", min: " << numeric.getMin()
+               << ", max: " << numeric.getMax() << endl;
+            os << "    p50: " << numeric.getQuantile(0.5) << ", p90: " << numeric.getQuantile(0.9)
+               << ", p99: " << numeric.getQuantile(0.99) << endl;
         }
+        if (numeric.getNonFiniteCount() > 0)
+            os << "    non-finite: " << numeric.getNonFiniteCount() << endl;
     }
 }
 
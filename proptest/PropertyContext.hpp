@@ -4,19 +4,39 @@
 #include "proptest/std/lang.hpp"
 #include "proptest/std/string.hpp"
 #include "proptest/std/io.hpp"
+#include "proptest/std/functional.hpp"
 #include "proptest/std/map.hpp"
+#include "proptest/std/optional.hpp"
 #include "proptest/std/list.hpp"
 #include "proptest/std/vector.hpp"
 #include "proptest/std/set.hpp"
+#include "proptest/std/thread.hpp"
 
 namespace proptest {
 
 enum class StatAssertType { GE, LE, IN_RANGE };
 
+/// Quantity of a statistic bounded by a stat assertion
+enum class StatMeasure {
+    TRUE_RATIO,  ///< ratio of runs where the value was true (PROP_STAT_ASSERT_*)
+    // aggregates of the values recorded with PROP_STAT_NUM (PROP_STAT_NUM_ASSERT_*)
+    MEAN,
+    STDDEV,
+    MIN,
+    MAX,
+    P50,
+    P90,
+    P99,
+};
+
+PROPTEST_API const char* statMeasureName(StatMeasure measure);
+
 struct StatAssertion
 {
-    StatAssertion(string key, StatAssertType type, double bound1, const char* file, int line, double bound2 = 0.0)
-        : key(util::move(key)), type(type), bound1(bound1), bound2(bound2), filename(file), lineno(line)
+    StatAssertion(string key, StatAssertType type, double bound1, const char* file, int line, double bound2 = 0.0,
+                  StatMeasure measure = StatMeasure::TRUE_RATIO)
+        : key(util::move(key)), type(type), bound1(bound1), bound2(bound2), filename(file), lineno(line),
+          measure(measure)
     {
     }
     string key;
@@ -25,15 +45,76 @@ struct StatAssertion
     double bound2;  // for IN_RANGE: min, max
     const char* filename;
     int lineno;
+    StatMeasure measure;
 };
 
-struct Tag
+/**
+ * @brief Constant-memory aggregates of the numeric values recorded with PROP_STAT_NUM
+ *
+ * Mean and variance are accumulated with Welford's method. Quantiles are read from a DDSketch-style histogram whose
+ * buckets grow geometrically, which keeps them within about 1% of the true value. At most kMaxBuckets buckets are kept
+ * per sign; beyond that the buckets of the smallest magnitudes are folded together. NaN and infinities are only
+ * counted.
+ */
+struct PROPTEST_API NumericStat
 {
-    Tag(const char* f, int l, const string& v) : filename(f), lineno(l), value(v), count(1) {}
-    const char* filename;
-    const int lineno;
-    string value;
-    size_t count;
+    static constexpr size_t kMaxBuckets = 2048;
+
+    void add(double value);
+    void merge(const NumericStat& other);
+
+    /// Number of finite values recorded
+    size_t getCount() const { return count; }
+    size_t getNonFiniteCount() const { return numNonFinite; }
+    double getMean() const { return mean; }
+    /// Population variance of the finite values
+    double getVariance() const;
+    double getStdDev() const;
+    double getMin() const { return minValue; }
+    double getMax() const { return maxValue; }
+    /// Approximate q-quantile (0 <= q <= 1) of the finite values
+    double getQuantile(double q) const;
+    /// Value of a PROP_STAT_NUM measure, or nullopt for TRUE_RATIO and when no finite value was recorded
+    optional<double> getMeasure(StatMeasure measure) const;
+
+private:
+    static int32_t bucketIndex(double magnitude);
+    static double bucketValue(int32_t index);
+    static void addBucket(map<int32_t, size_t>& buckets, int32_t index, size_t n);
+
+    size_t count = 0;
+    size_t numNonFinite = 0;
+    double mean = 0.0;
+    double m2 = 0.0;  // sum of squared differences from the mean
+    double minValue = 0.0;
+    double maxValue = 0.0;
+    size_t numZero = 0;
+    map<int32_t, size_t> positiveBuckets;
+    map<int32_t, size_t> negativeBuckets;  // indexed by magnitude
+};
+
+/**
+ * @brief Counts of the values recorded under one tag key
+ *
+ * Bool and integer values are counted in numeric form, other values by their text. Values are formatted only when
+ * the summary is printed. Values of PROP_STAT_NUM are aggregated in numeric instead of being counted.
+ */
+struct TagCounter
+{
+    explicit TagCounter(string k) : key(util::move(k)) {}
+    string key;
+    size_t numTrue = 0;
+    size_t numFalse = 0;
+    unordered_map<int64_t, size_t> intCounts;
+    unordered_map<uint64_t, size_t> uintCounts;
+    unordered_map<string, size_t> stringCounts;
+    NumericStat numeric;
+
+    /// Number of times the key was recorded as true (a bool value or the text "true")
+    size_t countTrue() const;
+    void merge(const TagCounter& other);
+    /// Value text -> count, sorted by the text
+    map<string, size_t> countsByText() const;
 };
 
 struct Failure
@@ -58,12 +139,28 @@ PROPTEST_API uint64_t getGlobalSeed();
 
 ostream& operator<<(ostream&, const Failure&);
 
+/**
+ * @brief Collects expectations, tags and stat assertions of a property run
+ *
+ * The active context is tracked per thread: constructing one makes it current on the calling thread until it is
+ * destroyed. Use PropertyContextBinding to route threads spawned by a property to the same context. All recording
+ * functions are synchronized, so one context may be shared by several threads.
+ */
 struct PROPTEST_API PropertyContext
 {
     PropertyContext();
     ~PropertyContext();
+    PropertyContext(const PropertyContext&) = delete;
+    PropertyContext& operator=(const PropertyContext&) = delete;
+
+    /// Returns the context active on the calling thread, or nullptr outside of a property run
+    static PropertyContext* current();
 
     void tag(const char* filename, int lineno, string key, string value);
+    void tagBool(const char* filename, int lineno, string_view key, bool value);
+    void tagInt(const char* filename, int lineno, string_view key, int64_t value);
+    void tagUInt(const char* filename, int lineno, string_view key, uint64_t value);
+    void tagNumeric(const char* filename, int lineno, string_view key, double value);
     void succeed(const char* filename, int lineno, const char* condition, const stringstream& str);
     void fail(const char* filename, int lineno, const char* condition, const stringstream& str);
     void fail(const char* filename, int lineno, string condition, const stringstream& str);
@@ -73,20 +170,70 @@ struct PROPTEST_API PropertyContext
     void printSummary(ostream& os = cout);
     bool hasFailures() const { return !failures.empty(); }
 
-    void addStatAssertGe(string&& key, double minBound, const char* filename, int lineno);
-    void addStatAssertLe(string&& key, double maxBound, const char* filename, int lineno);
-    void addStatAssertInRange(string&& key, double minBound, double maxBound, const char* filename, int lineno);
+    void addStatAssertGe(string&& key, double minBound, const char* filename, int lineno,
+                         StatMeasure measure = StatMeasure::TRUE_RATIO);
+    void addStatAssertLe(string&& key, double maxBound, const char* filename, int lineno,
+                         StatMeasure measure = StatMeasure::TRUE_RATIO);
+    void addStatAssertInRange(string&& key, double minBound, double maxBound, const char* filename, int lineno,
+                              StatMeasure measure = StatMeasure::TRUE_RATIO);
     bool checkStatAssertions(size_t totalRuns);
+    /// Accumulates tags and stat assertions collected by another context (e.g. a parallel worker)
+    void merge(const PropertyContext& other);
 
 private:
-    // key -> (value -> Tag(count, detail))
-    map<string, map<string, Tag> > tags;
+    struct TagSite
+    {
+        const char* filename;
+        int lineno;
+        bool operator==(const TagSite& other) const { return filename == other.filename && lineno == other.lineno; }
+    };
+    struct TagSiteHash
+    {
+        size_t operator()(const TagSite& site) const
+        {
+            return hash<const char*>()(site.filename) ^ (static_cast<size_t>(site.lineno) * 0x9e3779b97f4a7c15ULL);
+        }
+    };
+
+    /// Counter of the key, looked up by the call site first (requires mtx)
+    TagCounter& tagCounter(const char* filename, int lineno, string_view key);
+
+    vector<TagCounter> tagCounters;
+    unordered_map<string, size_t> tagIndex;  // key -> index in tagCounters
+    // call site -> index of the key last recorded there; a site almost always records a single key
+    unordered_map<TagSite, size_t, TagSiteHash> tagSites;
     list<Failure> failures;
     vector<StatAssertion> statAssertions;
     set<string> statAssertKeys;  // for deduplication
-    bool lastStreamExists;
+    size_t flushCount;  // invalidates per-thread last streams recorded before a flush
+    mutable mutex mtx;
 
     PropertyContext* oldContext;
 };
 
+/**
+ * @brief Makes a context current on the calling thread for the lifetime of the binding
+ *
+ * Threads spawned from within a property do not inherit the property's context. Bind it explicitly so that
+ * PROP_EXPECT, PROP_TAG and PROP_STAT in the thread are recorded by the property:
+ * @code
+ * auto* ctx = PropertyContext::current();
+ * thread t([ctx]() {
+ *     PropertyContextBinding binding(ctx);
+ *     PROP_EXPECT(...);
+ * });
+ * @endcode
+ */
+class PROPTEST_API PropertyContextBinding
+{
+public:
+    explicit PropertyContextBinding(PropertyContext* context);
+    ~PropertyContextBinding();
+    PropertyContextBinding(const PropertyContextBinding&) = delete;
+    PropertyContextBinding& operator=(const PropertyContextBinding&) = delete;
+
+private:
+    PropertyContext* oldContext;
+};
+
 }  // namespace proptest
@@ -1,26 +1,126 @@
 #include "proptest/Random.hpp"
 #include "proptest/std/chrono.hpp"
+#include <cstdlib>
 
 namespace proptest {
 
-Random::Random(uint64_t seed) : engine(seed) {}
+namespace {
 
-Random::Random(const Random& other) : engine(other.engine), dist(other.dist) {}
+// 64x64 -> 128 bit product
+void multiply(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo)
+{
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    hi = static_cast<uint64_t>(product >> 64);
+    lo = static_cast<uint64_t>(product);
+#else
+    const uint64_t aLo = a & 0xffffffffULL, aHi = a >> 32;
+    const uint64_t bLo = b & 0xffffffffULL, bHi = b >> 32;
+    const uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+    const uint64_t mid = (ll >> 32) + (lh & 0xffffffffULL) + (hl & 0xffffffffULL);
+    hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    lo = (mid << 32) | (ll & 0xffffffffULL);
+#endif
+}
+
+// [min, max] is drawn as min + [0, max - min]; unsigned wrap-around makes this work for signed types too
+template <typename T>
+uint64_t rangeOf(T min, T max)
+{
+    return static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+}
+
+template <typename T>
+T offsetFrom(T min, uint64_t offset)
+{
+    return static_cast<T>(static_cast<uint64_t>(min) + offset);
+}
+
+variant<mt19937_64, util::Xoshiro256ss> makeEngine(uint64_t seed, RandomEngine engineType)
+{
+    if (engineType == RandomEngine::XOSHIRO256SS)
+        return util::Xoshiro256ss(seed);
+    return mt19937_64(seed);
+}
+
+}  // namespace
+
+Random::Random(uint64_t seed, RandomEngine engineType) : engine(makeEngine(seed, engineType)) {}
+
+Random::Random(const Random& other) : engine(other.engine), dist(other.dist), sizeFactor(other.sizeFactor) {}
 
 Random& Random::operator=(const Random& other)
 {
     engine = other.engine;
     dist = other.dist;
+    sizeFactor = other.sizeFactor;
 
     return *this;
 }
 
+RandomEngine Random::getEngineType() const
+{
+    return holds_alternative<util::Xoshiro256ss>(engine) ? RandomEngine::XOSHIRO256SS : RandomEngine::MT19937_64;
+}
+
 uint64_t Random::next8U()
 {
-    auto value = dist(engine);
+    if (auto* xoshiro = get_if<util::Xoshiro256ss>(&engine))
+        return (*xoshiro)();
+    auto value = dist(*get_if<mt19937_64>(&engine));
     return value;
 }
 
+uint64_t Random::boundedU(uint64_t range)
+{
+    auto& xoshiro = *get_if<util::Xoshiro256ss>(&engine);
+    if (range == UINT64_MAX)
+        return xoshiro();
+
+    // Lemire, "Fast Random Integer Generation in an Interval": the high word of x * bound is uniform
+    // once the few low words below (2^64 mod bound) are rejected
+    const uint64_t bound = range + 1;
+    uint64_t hi, lo;
+    multiply(xoshiro(), bound, hi, lo);
+    if (lo < bound) {
+        const uint64_t threshold = (0 - bound) % bound;
+        while (lo < threshold)
+            multiply(xoshiro(), bound, hi, lo);
+    }
+    return hi;
+}
+
+void Random::fillUInt64(span<uint64_t> out)
+{
+    if (auto* xoshiro = get_if<util::Xoshiro256ss>(&engine)) {
+        for (auto& word : out)
+            word = (*xoshiro)();
+        return;
+    }
+    auto& mt = *get_if<mt19937_64>(&engine);
+    for (auto& word : out)
+        word = dist(mt);
+}
+
+void Random::fillUInt32(span<uint32_t> out, uint32_t min, uint32_t max)
+{
+    const uint64_t bound = static_cast<uint64_t>(max) - min + 1;
+    const uint64_t threshold = (0 - bound) % bound;
+    uint64_t words[64];
+    for (size_t done = 0; done < out.size();) {
+        const size_t n = out.size() - done < 64 ? out.size() - done : 64;
+        fillUInt64(span<uint64_t>(words, n));
+        for (size_t i = 0; i < n; i++) {
+            uint64_t hi, lo;
+            multiply(words[i], bound, hi, lo);
+            while (lo < threshold)
+                multiply(getRandomUInt64(), bound, hi, lo);
+            out[done + i] = min + static_cast<uint32_t>(hi);
+        }
+        done += n;
+    }
+}
+
 bool Random::getRandomBool(double threshold)
 {
     if(threshold == 1.0)
@@ -30,50 +130,66 @@ bool Random::getRandomBool(double threshold)
 
 int8_t Random::getRandomInt8(int8_t min, int8_t max)
 {
+    if (holds_alternative<util::Xoshiro256ss>(engine))
+        return offsetFrom(min, boundedU(rangeOf(min, max)));
     uniform_int_distribution<int> dist(min, max);
-    return static_cast<int8_t>(dist(engine));
+    return static_cast<int8_t>(dist(*get_if<mt19937_64>(&engine)));
 }
 
 uint8_t Random::getRandomUInt8(uint8_t min, uint8_t max)
 {
+    if (holds_alternative<util::Xoshiro256ss>(engine))
+        return offsetFrom(min, boundedU(rangeOf(min, max)));
     uniform_int_distribution<int> dist(min, max);
-    return static_cast<uint8_t>(dist(engine));
+    return static_cast<uint8_t>(dist(*get_if<mt19937_64>(&engine)));
 }
 
 int16_t Random::getRandomInt16(int16_t min, int16_t max)
 {
+    if (holds_alternative<util::Xoshiro256ss>(engine))
+        return offsetFrom(min, boundedU(rangeOf(min, max)));
     uniform_int_distribution<int> dist(min, max);
-    return static_cast<int16_t>(dist(engine));
+    return static_cast<int16_t>(dist(*get_if<mt19937_64>(&engine)));
 }
 
 uint16_t Random::getRandomUInt16(uint16_t min, uint16_t max)
 {
+    if (holds_alternative<util::Xoshiro256ss>(engine))
+        return offsetFrom(min, boundedU(rangeOf(min, max)));
     uniform_int_distribution<int> dist(min, max);
-    return static_cast<uint16_t>(dist(engine));
+    return static_cast<uint16_t>(dist(*get_if<mt19937_64>(&engine)));
 }
 
 int32_t Random::getRandomInt32(int32_t min, int32_t max)
 {
+    if (holds_alternative<util::Xoshiro256ss>(engine))
+        return offsetFrom(min, boundedU(rangeOf(min, max)));
     uniform_int_distribution<int32_t> dist(min, max);
-    return static_cast<int32_t>(dist(engine));
+    return static_cast<int32_t>(dist(*get_if<mt19937_64>(&engine)));
 }
 
 uint32_t Random::getRandomUInt32(uint32_t min, uint32_t max)
 {
+    if (holds_alternative<util::Xoshiro256ss>(engine))
+        return offsetFrom(min, boundedU(rangeOf(min, max)));
     uniform_int_distribution<uint32_t> dist(min, max);
-    return static_cast<uint32_t>(dist(engine));
+    return static_cast<uint32_t>(dist(*get_if<mt19937_64>(&engine)));
 }
 
 int64_t Random::getRandomInt64(int64_t min, int64_t max)
 {
+    if (holds_alternative<util::Xoshiro256ss>(engine))
+        return offsetFrom(min, boundedU(rangeOf(min, max)));
     uniform_int_distribution<int64_t> dist(min, max);
-    return static_cast<int64_t>(dist(engine));
+    return static_cast<int64_t>(dist(*get_if<mt19937_64>(&engine)));
 }
 
 uint64_t Random::getRandomUInt64(uint64_t min, uint64_t max)
 {
+    if (holds_alternative<util::Xoshiro256ss>(engine))
+        return offsetFrom(min, boundedU(rangeOf(min, max)));
     uniform_int_distribution<uint64_t> dist(min, max);
-    return static_cast<uint64_t>(dist(engine));
+    return static_cast<uint64_t>(dist(*get_if<mt19937_64>(&engine)));
 }
 
 // [fromIncluded, toExcluded)
@@ -82,30 +198,42 @@ uint32_t Random::getRandomSize(size_t fromIncluded, size_t toExcluded)
     return getRandomUInt32(fromIncluded, toExcluded-1);
 }
 
+uint32_t Random::getRandomContainerSize(size_t minSize, size_t maxSize)
+{
+    if (sizeFactor < 1.0 && maxSize > minSize)
+        maxSize = minSize + static_cast<size_t>(static_cast<double>(maxSize - minSize) * sizeFactor);
+    return getRandomSize(minSize, maxSize + 1);
+}
+
+void Random::setSizeFactor(double factor)
+{
+    sizeFactor = factor < 0.0 ? 0.0 : (factor > 1.0 ? 1.0 : factor);
+}
+
 float Random::getRandomFloat()
 {
     uniform_real_distribution<float> dist;
-    return dist(engine);
+    return visit([&dist](auto& eng) { return dist(eng); }, engine);
 }
 
 double Random::getRandomDouble()
 {
     uniform_real_distribution<double> dist;
-    return dist(engine);
+    return visit([&dist](auto& eng) { return dist(eng); }, engine);
 }
 
 // [min, max)
 float Random::getRandomFloat(float min, float max)
 {
     uniform_real_distribution<float> dist(min, max);
-    return dist(engine);
+    return visit([&dist](auto& eng) { return dist(eng); }, engine);
 }
 
 // [min, max)
 double Random::getRandomDouble(double min, double max)
 {
     uniform_real_distribution<double> dist(min, max);
-    return dist(engine);
+    return visit([&dist](auto& eng) { return dist(eng); }, engine);
 }
 
 
@@ -117,6 +245,46 @@ int64_t getCurrentTime()
     return millis;
 }
 
+namespace util {
+
+uint64_t deriveSeed(uint64_t seed, uint64_t streamIndex)
+{
+    // splitmix64 finalizer over (seed, index) gives well-separated streams for nearby indices
+    uint64_t z = seed + (streamIndex + 1) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+RandomEngine getGlobalRandomEngine()
+{
+    static const char* env_engine = std::getenv("PROPTEST_RANDOM_ENGINE");
+    if (!env_engine || string(env_engine) == randomEngineName(RandomEngine::MT19937_64))
+        return RandomEngine::MT19937_64;
+    if (string(env_engine) == randomEngineName(RandomEngine::XOSHIRO256SS))
+        return RandomEngine::XOSHIRO256SS;
+    throw runtime_error(__FILE__, __LINE__, "unknown PROPTEST_RANDOM_ENGINE: " + string(env_engine));
+}
+
+const char* randomEngineName(RandomEngine engine)
+{
+    return engine == RandomEngine::XOSHIRO256SS ? "xoshiro256ss" : "mt19937_64";
+}
+
+Xoshiro256ss::Xoshiro256ss(uint64_t seed)
+{
+    // the reference seeding: consecutive splitmix64 outputs, never all zero
+    for (auto& word : s) {
+        seed += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        word = z ^ (z >> 31);
+    }
+}
+
+}  // namespace util
+
 template <>
 char Random::getRandom<char>(int64_t min, int64_t max)
 {
@@ -4,6 +4,8 @@
 #include "proptest/std/random.hpp"
 #include "proptest/std/concepts.hpp"
 #include "proptest/std/exception.hpp"
+#include "proptest/std/span.hpp"
+#include "proptest/std/variant.hpp"
 
 /**
  * @file Random.hpp
@@ -14,9 +16,62 @@ namespace proptest {
 
 PROPTEST_API int64_t getCurrentTime();
 
+/**
+ * @brief Engine behind Random
+ *
+ * A seed reproduces the same values only with the same engine.
+ */
+enum class RandomEngine {
+    MT19937_64,    ///< std::mt19937_64 with standard distributions (default)
+    XOSHIRO256SS,  ///< xoshiro256** with Lemire's bounded integers; 32 bytes of state, much cheaper to copy
+};
+
+namespace util {
+/// Derives an independent seed for the given stream index (splitmix64), e.g. for parallel workers
+PROPTEST_API uint64_t deriveSeed(uint64_t seed, uint64_t streamIndex);
+
+/// Engine of properties that do not set one: PROPTEST_RANDOM_ENGINE ("mt19937_64" or "xoshiro256ss"), or MT19937_64
+PROPTEST_API RandomEngine getGlobalRandomEngine();
+
+/// Name of the engine as accepted by PROPTEST_RANDOM_ENGINE
+PROPTEST_API const char* randomEngineName(RandomEngine engine);
+
+/**
+ * @brief xoshiro256** 1.0 by Blackman and Vigna, with its state seeded by splitmix64
+ */
+struct PROPTEST_API Xoshiro256ss
+{
+    using result_type = uint64_t;
+
+    explicit Xoshiro256ss(uint64_t seed);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()()
+    {
+        const uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t s[4];
+};
+
+}  // namespace util
+
 class PROPTEST_API Random {
 public:
-    Random(uint64_t seed);
+    Random(uint64_t seed, RandomEngine engineType = RandomEngine::MT19937_64);
     Random(const Random& other);
     bool getRandomBool(double threshold = 0.5);
     int8_t getRandomInt8(int8_t min = INT8_MIN, int8_t max = INT8_MAX);
@@ -33,6 +88,35 @@ public:
     double getRandomDouble(double min, double max);
     uint32_t getRandomSize(size_t fromIncluded, size_t toExcluded);
 
+    /**
+     * @brief Size of a generated container in [minSize, maxSize], scaled down by the size factor
+     *
+     * With a size factor below 1, the upper bound shrinks towards minSize. With the default factor of 1, it
+     * draws the same value as getRandomSize(minSize, maxSize + 1).
+     */
+    uint32_t getRandomContainerSize(size_t minSize, size_t maxSize);
+
+    /// Fraction in [0, 1] of the maximum size that generators should use; the run loop grows it when enabled
+    double getSizeFactor() const { return sizeFactor; }
+    void setSizeFactor(double factor);
+
+    /**
+     * @brief Fills the buffer with random 64-bit words
+     *
+     * Draws the same values as calling getRandomUInt64() once per element, without the per-call overhead.
+     */
+    void fillUInt64(span<uint64_t> out);
+
+    /**
+     * @brief Fills the buffer with uniform values in [min, max]
+     *
+     * Draws 64-bit words in bulk with fillUInt64() and maps them into the range with Lemire's multiply-shift,
+     * rejecting the few biased words. Cheaper than a bounded draw per element, but draws different values.
+     */
+    void fillUInt32(span<uint32_t> out, uint32_t min, uint32_t max);
+
+    RandomEngine getEngineType() const;
+
     Random& operator=(const Random& other);
 
     template <typename T>
@@ -53,9 +137,13 @@ public:
 
 private:
     uint64_t next8U();
-    // default_random_engine engine;
-    mt19937_64 engine;
+    /// Uniform value in [0, range] from the xoshiro engine (Lemire's multiply-shift with rejection)
+    uint64_t boundedU(uint64_t range);
+
+    // only the active engine is copied, so copies of a xoshiro-backed Random stay cheap
+    variant<mt19937_64, util::Xoshiro256ss> engine;
     uniform_int_distribution<uint64_t> dist;
+    double sizeFactor = 1.0;
 };
 
 template <>
@@ -0,0 +1,87 @@
+#include "proptest/RunStats.hpp"
+#include "proptest/std/thread.hpp"
+
+namespace proptest {
+
+namespace {
+
+atomic<util::AllocationCounter> allocationCounter{nullptr};
+
+void printPhase(ostream& os, const char* name, const PhaseStats& phase, bool countsAllocations)
+{
+    os << "  " << name << ": " << phase.count << " calls, " << phase.elapsedSec << "s";
+    if (countsAllocations)
+        os << ", " << phase.allocations << " allocations";
+}
+
+}  // namespace
+
+void PhaseStats::merge(const PhaseStats& other)
+{
+    count += other.count;
+    elapsedSec += other.elapsedSec;
+    allocations += other.allocations;
+}
+
+void RunStats::merge(const RunStats& other)
+{
+    generation.merge(other.generation);
+    function.merge(other.function);
+    startup.merge(other.startup);
+    cleanup.merge(other.cleanup);
+    shrink.merge(other.shrink);
+    numShrinkCandidates += other.numShrinkCandidates;
+    countsAllocations = countsAllocations || other.countsAllocations;
+}
+
+ostream& operator<<(ostream& os, const RunStats& stats)
+{
+    os << "run stats:" << endl;
+    printPhase(os, "generation", stats.generation, stats.countsAllocations);
+    os << endl;
+    printPhase(os, "function", stats.function, stats.countsAllocations);
+    os << endl;
+    printPhase(os, "startup", stats.startup, stats.countsAllocations);
+    os << endl;
+    printPhase(os, "cleanup", stats.cleanup, stats.countsAllocations);
+    os << endl;
+    printPhase(os, "shrink", stats.shrink, stats.countsAllocations);
+    os << ", " << stats.numShrinkCandidates << " candidates" << endl;
+    return os;
+}
+
+namespace util {
+
+void setAllocationCounter(AllocationCounter counter)
+{
+    allocationCounter = counter;
+}
+
+AllocationCounter getAllocationCounter()
+{
+    return allocationCounter;
+}
+
+PhaseTimer::PhaseTimer(PhaseStats* stats) : stats(stats), allocationsBefore(0)
+{
+    if (!stats)
+        return;
+    if (auto counter = getAllocationCounter())
+        allocationsBefore = counter();
+    start = steady_clock::now();
+}
+
+PhaseTimer::~PhaseTimer()
+{
+    if (!stats)
+        return;
+    const auto end = steady_clock::now();
+    stats->count++;
+    stats->elapsedSec += std::chrono::duration<double>(end - start).count();
+    if (auto counter = getAllocationCounter())
+        stats->allocations += counter() - allocationsBefore;
+}
+
+}  // namespace util
+
+}  // namespace proptest
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "proptest/api.hpp"
+#include "proptest/std/chrono.hpp"
+#include "proptest/std/io.hpp"
+
+/**
+ * @file RunStats.hpp
+ * @brief Per-phase timing and allocation counts of property runs
+ */
+
+namespace proptest {
+
+/// Time and heap allocations spent in one phase of a property run
+struct PROPTEST_API PhaseStats
+{
+    uint64_t count = 0;        ///< number of times the phase ran
+    double elapsedSec = 0.0;
+    uint64_t allocations = 0;  ///< only counted while an allocation counter is installed
+
+    void merge(const PhaseStats& other);
+};
+
+/**
+ * @brief Breakdown of a forAll run by phase
+ *
+ * Generation and the property function are measured in the run loop. The shrink phase is measured as a whole,
+ * including the generation, startup, cleanup and property calls of the candidates it tests.
+ */
+struct PROPTEST_API RunStats
+{
+    PhaseStats generation;  ///< generating the arguments (callFunctionFromGen)
+    PhaseStats function;    ///< calling the property function
+    PhaseStats startup;     ///< onStartup callbacks
+    PhaseStats cleanup;     ///< onCleanup callbacks
+    PhaseStats shrink;      ///< shrink()
+    uint64_t numShrinkCandidates = 0;
+    /// Whether allocation counts are available (see util::setAllocationCounter)
+    bool countsAllocations = false;
+
+    void merge(const RunStats& other);
+};
+
+PROPTEST_API ostream& operator<<(ostream& os, const RunStats& stats);
+
+namespace util {
+
+using AllocationCounter = uint64_t (*)();
+
+/**
+ * @brief Installs a function returning the number of heap allocations made so far, or removes it with nullptr
+ *
+ * The library does not replace the global allocation functions itself. A test binary that counts its allocations,
+ * e.g. with a replaced operator new, can pass the count to RunStats with this. The count is process-wide, so
+ * allocations of other threads show up in the phase they overlap with.
+ */
+PROPTEST_API void setAllocationCounter(AllocationCounter counter);
+PROPTEST_API AllocationCounter getAllocationCounter();
+
+/**
+ * @brief Adds the time and allocations of its lifetime to a PhaseStats
+ *
+ * Does nothing when given nullptr, so that uninstrumented runs pay only for the check.
+ */
+class PROPTEST_API PhaseTimer
+{
+public:
+    explicit PhaseTimer(PhaseStats* stats);
+    ~PhaseTimer();
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    PhaseStats* stats;
+    steady_clock::time_point start;
+    uint64_t allocationsBefore;
+};
+
+}  // namespace util
+
+}  // namespace proptest
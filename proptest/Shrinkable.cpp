@@ -18,7 +18,7 @@ ShrinkableBase ShrinkableBase::with(Function<StreamType()> otherStreamGen) const
     return ShrinkableBase(value, otherStreamGen);
 }
 
-Any ShrinkableBase::getAny() const { return value; }
+const Any& ShrinkableBase::getAny() const { return value; }
 
 ShrinkableBase ShrinkableBase::clone() const {
     return ShrinkableBase(value.clone(), shrinksGen);
@@ -50,7 +50,7 @@ struct PROPTEST_API ShrinkableBase
     }
 
     template <typename T> T& getMutableRef() { return value.getMutableRef<T>(); }
-    Any getAny() const;
+    const Any& getAny() const;
 
     ShrinkableBase clone() const;
 
@@ -97,6 +97,12 @@ public:
     friend Shrinkable<T> proptest::make_shrinkable(ARGS&&... args);
 };
 
+/**
+ * @brief Typed view of a ShrinkableBase
+ *
+ * The value and its shrinks are still stored type-erased (an Any and a Stream of ShrinkableBase); T only types the
+ * accessors. Both have the same layout, so converting at combinator boundaries copies nothing but the handles.
+ */
 template <typename T>
 struct Shrinkable : public ShrinkableBase
 {
@@ -1,4 +1,6 @@
 #include "proptest/combinator/filter.hpp"
+#include "proptest/util/assert.hpp"
+#include "proptest/util/discard_stats.hpp"
 
 namespace proptest {
 
@@ -7,13 +9,18 @@ namespace util {
 GeneratorCommon filterImpl(Function1<ShrinkableBase> gen, Function1<bool> criteria)
 {
     return GeneratorCommon([gen, criteria](Random& rand) {
-        // TODO: add some configurable termination criteria (e.g. maximum no. of attempts)
-        while (true) {
+        DiscardStats* stats = getDiscardStats();
+        const uint32_t maxAttempts = stats ? stats->maxFilterAttempts : kDefaultMaxFilterAttempts;
+        for (uint32_t attempt = 0; maxAttempts == 0 || attempt < maxAttempts; attempt++) {
             ShrinkableBase shrinkable = gen.callDirect(rand);
-            if (criteria(shrinkable.getAny())) {
+            const bool accepted = criteria(shrinkable.getAny());
+            if (stats)
+                stats->countFilterDraw(accepted);
+            if (accepted)
                 return shrinkable.filter(criteria, 1);  // 1: tolerance
-            }
         }
+        // give up on the run; forAll counts it as discarded
+        throw Discard(__FILE__, __LINE__, {}, "", nullptr);
     });
 }
 
@@ -21,6 +21,8 @@ namespace gen {
  * @tparam GEN base generator for type T
  * @tparam Criteria a callable with signature T& -> bool
  * @details returns a generator for type T that satisfies criteria predicate (criteria(t) returns true)
+ * If no value is accepted within the max filter attempts of the property (10000 by default, see
+ * Property::setMaxFilterAttempts), the generator throws Discard and the run is discarded.
  * @code
  * // returns generator for even numbers only out of values generated by intGen
  * filter<int>(intGen, [](int& num) { return num % 2 == 0; });
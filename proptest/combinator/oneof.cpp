@@ -1,4 +1,5 @@
 #include "proptest/Generator.hpp"
+#include "proptest/util/alias_table.hpp"
 
 namespace proptest {
 
@@ -28,24 +29,18 @@ GeneratorCommon oneOfImpl(const shared_ptr<vector<util::WeightedBase>>& genVecPt
                 weight = (1.0 - sum) / static_cast<double>(numUnassigned);
         }
 
-    return Function1<ShrinkableBase>([genVecPtr](Random& rand) {
-        while (true) {
-            auto dice = rand.getRandomSize(0, genVecPtr->size());
-            const util::WeightedBase& weighted = (*genVecPtr)[dice];
-            if (rand.getRandomBool(weighted.weight)) {
-                // retry the same generator if an exception is thrown
-                [[maybe_unused]] uint64_t numRetry = 0;
-                while (true) {
-                    try {
-                        return weighted.func.callDirect(rand);
-                    } catch (const Discard&) {
-                        // TODO: trace level low
-                    }
-                    numRetry++;
-                    // TODO: trace level low
-                }
-            }
-        };
+    // built once: each value then takes one index and one coin, instead of retrying until a weighted coin succeeds
+    vector<double> weights;
+    weights.reserve(genVecPtr->size());
+    for (const auto& weighted : *genVecPtr)
+        weights.push_back(weighted.weight);
+    auto aliasTable = util::make_shared<AliasTable>(weights);
+
+    // a branch that throws Discard (e.g. a filter that used up its attempts) is not retried: retrying would only
+    // repeat those attempts, and never end for a filter that accepts nothing. forAll counts the run as discarded.
+    return Function1<ShrinkableBase>([genVecPtr, aliasTable](Random& rand) {
+        const util::WeightedBase& weighted = (*genVecPtr)[aliasTable->pick(rand)];
+        return weighted.func.callDirect(rand);
     });
 }
 
@@ -9,15 +9,16 @@ namespace proptest {
 size_t Arbi<CESU8String>::defaultMinSize = 0;
 size_t Arbi<CESU8String>::defaultMaxSize = 200;
 
-Arbi<CESU8String>::Arbi(size_t _minSize, size_t _maxSize) : ArbiContainer<CESU8String>(_minSize, _maxSize), elemGen(gen::unicode()) {}
+Arbi<CESU8String>::Arbi(size_t _minSize, size_t _maxSize) : ArbiContainer<CESU8String>(_minSize, _maxSize), elemGen(gen::unicode()), unicodeElemGen(true) {}
 
-Arbi<CESU8String>::Arbi(GenFunction<uint32_t> _elemGen, size_t _minSize, size_t _maxSize) : ArbiContainer<CESU8String>(_minSize, _maxSize), elemGen(_elemGen) {}
+Arbi<CESU8String>::Arbi(GenFunction<uint32_t> _elemGen, size_t _minSize, size_t _maxSize) : ArbiContainer<CESU8String>(_minSize, _maxSize), elemGen(_elemGen), unicodeElemGen(false) {}
 
 Arbi<CESU8String>::Arbi(const util::ContainerGenConfig<uint32_t>& config)
     : ArbiContainer<CESU8String>(
           config.minSize.value_or(defaultMinSize),
           config.maxSize.value_or(defaultMaxSize)),
-      elemGen(config.elemGen.value_or(gen::unicode())) {}
+      elemGen(config.elemGen.value_or(gen::unicode())),
+      unicodeElemGen(!config.elemGen.has_value()) {}
 
 
 /*
@@ -36,7 +37,7 @@ Arbi<CESU8String>::Arbi(const util::ContainerGenConfig<uint32_t>& config)
  */
 Shrinkable<CESU8String> Arbi<CESU8String>::operator()(Random& rand) const
 {
-    size_t len = rand.getRandomSize(minSize, maxSize + 1);
+    size_t len = rand.getRandomContainerSize(minSize, maxSize);
     vector<uint8_t> chars /*, allocator()*/;
     vector<int> positions /*, allocator()*/;
     vector<uint32_t> codes;
@@ -47,12 +48,16 @@ Shrinkable<CESU8String> Arbi<CESU8String>::operator()(Random& rand) const
 
     // cout << "cesu8 gen, len = " << len << endl;
 
-    for (size_t i = 0; i < len; i++) {
+    if (unicodeElemGen) {
+        codes.resize(len);
+        util::fillUnicode(rand, codes);
+    } else {
         // U+D800..U+DFFF is forbidden for surrogate use
-        Shrinkable<uint32_t> codeShr = elemGen(rand);
-        uint32_t code = codeShr.getRef();
+        for (size_t i = 0; i < len; i++)
+            codes.push_back(elemGen(rand).getRef());
+    }
+    for (uint32_t code : codes) {
         positions.push_back(chars.size());
-        codes.push_back(code);
         util::encodeCESU8(code, chars);
     }
     positions.push_back(chars.size());
@@ -36,6 +36,8 @@ public:
 
 private:
     GenFunction<uint32_t> elemGen;
+    /// elemGen is gen::unicode(), so code points can be drawn in bulk without building Shrinkables
+    bool unicodeElemGen;
 };
 
 }  // namespace proptest
@@ -5,7 +5,7 @@
 namespace proptest {
 
 template <typename T>
-Shrinkable<T> generateIntegerImpl(Random& rand, T min = numeric_limits<T>::min(), T max = numeric_limits<T>::max())
+T generateIntegerValueImpl(Random& rand, T min, T max)
 {
     T value = 0;
     // TODO: trueProb arg for boundary values
@@ -19,19 +19,21 @@ Shrinkable<T> generateIntegerImpl(Random& rand, T min = numeric_limits<T>::min()
 
     if (value < min || max < value)
         throw runtime_error(__FILE__, __LINE__, "invalid range");
+    return value;
+}
+
+template <typename T>
+Shrinkable<T> generateIntegerImpl(Random& rand, T min = numeric_limits<T>::min(), T max = numeric_limits<T>::max())
+{
+    const T value = generateIntegerValueImpl<T>(rand, min, max);
 
+    // shrink trees are built directly in T with the range offset applied per node, instead of mapping a 64-bit tree
     if (min >= 0)  // [3,5] -> [0,2] -> [3,5]
-    {
-        return util::binarySearchShrinkableU(static_cast<T>(value - min))
-            .template map<T>([min](const uint64_t& _value) { return static_cast<T>(_value + min); });
-    } else if (max <= 0)  // [-5,-3] -> [-2,0] -> [-5,-3]
-    {
-        return util::binarySearchShrinkable(static_cast<T>(value - max)).template map<T>([max](const int64_t& _value) { return static_cast<T>(_value + max); });
-    } else  // [-2, 2]
-    {
-        auto transformer = +[](const int64_t& _value) { return static_cast<T>(_value); };
-        return util::binarySearchShrinkable(value).template map<T>(transformer);
-    }
+        return util::binarySearchShrinkableWithOffset<T>(static_cast<T>(value - min), min);
+    else if (max <= 0)  // [-5,-3] -> [-2,0] -> [-5,-3]
+        return util::binarySearchShrinkableWithOffset<T>(static_cast<T>(value - max), max);
+    else  // [-2, 2]
+        return util::binarySearchShrinkableWithOffset<T>(value, 0);
 }
 
 
@@ -92,6 +94,15 @@ Shrinkable<uint64_t> generateInteger(Random& rand, uint64_t min, uint64_t max) {
 
 
 
+namespace util {
+
+#define DEFINE_GENERATEINTEGERVALUE(TYPE) \
+    template <> TYPE generateIntegerValue(Random& rand, TYPE min, TYPE max) { return generateIntegerValueImpl<TYPE>(rand, min, max); }
+
+DEFINE_FOR_ALL_INTTYPES(DEFINE_GENERATEINTEGERVALUE);
+
+}  // namespace util
+
 Shrinkable<char> Arbi<char>::operator()(Random& rand) const
 {
     return generateInteger<char>(rand);
@@ -47,6 +47,19 @@ PROPTEST_API Shrinkable<T> generateInteger(Random& rand, T min = numeric_limits<
 
 DEFINE_FOR_ALL_INTTYPES(SPECIALIZE_GENERATEINTEGER);
 
+namespace util {
+
+/// Draws the value generateInteger() would return, without building its Shrinkable
+template <typename T>
+T generateIntegerValue(Random& rand, T min = numeric_limits<T>::min(), T max = numeric_limits<T>::max());
+
+#define SPECIALIZE_GENERATEINTEGERVALUE(TYPE) \
+    template <> PROPTEST_API TYPE generateIntegerValue(Random& rand, TYPE min, TYPE max)
+
+DEFINE_FOR_ALL_INTTYPES(SPECIALIZE_GENERATEINTEGERVALUE);
+
+}  // namespace util
+
 template <integral T>
 class PROPTEST_API Arbi<T> final : public ArbiBase<T> {
 public:
@@ -67,7 +67,7 @@ public:
 
     Shrinkable<ContainerType> operator()(Random& rand) const override
     {
-        size_t size = rand.getRandomSize(minSize, maxSize + 1);
+        size_t size = rand.getRandomContainerSize(minSize, maxSize);
         auto shrinkVec = make_shrinkable<vector<ShrinkableBase>>();
         shrinkVec.getMutableRef().reserve(size);
         for (size_t i = 0; i < size; i++)
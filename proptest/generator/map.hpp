@@ -47,7 +47,7 @@ public:
 
     Shrinkable<Map> operator()(Random& rand) const override
     {
-        size_t size = rand.getRandomSize(minSize, maxSize + 1);
+        size_t size = rand.getRandomContainerSize(minSize, maxSize);
         set<Shrinkable<Pair>> pairShrSet;
 
         while (pairShrSet.size() < size) {
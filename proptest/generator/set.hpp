@@ -44,7 +44,7 @@ public:
     Shrinkable<Set> operator()(Random& rand) const override
     {
         // generate random Ts using elemGen
-        size_t size = rand.getRandomSize(minSize, maxSize + 1);
+        size_t size = rand.getRandomContainerSize(minSize, maxSize);
         auto shrinkableSet = util::make_shared<set<Shrinkable<T>>>();
 
         while (shrinkableSet->size() < size) {
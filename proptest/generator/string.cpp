@@ -9,22 +9,34 @@ size_t Arbi<string>::defaultMaxSize = 200;
 
 // defaults to ascii characters
 
-Arbi<string>::Arbi(size_t _minSize, size_t _maxSize) : ArbiContainer<string>(_minSize, _maxSize), elemGen(gen::interval<char>(0x1, 0x7f)) {}
+Arbi<string>::Arbi(size_t _minSize, size_t _maxSize) : ArbiContainer<string>(_minSize, _maxSize), elemGen(gen::interval<char>(0x1, 0x7f)), asciiElemGen(true) {}
 
-Arbi<string>::Arbi(Generator<char> _elemGen, size_t _minSize, size_t _maxSize) : ArbiContainer<string>(_minSize, _maxSize), elemGen(_elemGen) {}
+Arbi<string>::Arbi(Generator<char> _elemGen, size_t _minSize, size_t _maxSize) : ArbiContainer<string>(_minSize, _maxSize), elemGen(_elemGen), asciiElemGen(false) {}
 
 Arbi<string>::Arbi(const util::ContainerGenConfig<char>& config)
     : ArbiContainer<string>(
           config.minSize.value_or(defaultMinSize),
           config.maxSize.value_or(defaultMaxSize)),
-      elemGen(config.elemGen.has_value() ? Generator<char>(config.elemGen.value()) : gen::interval<char>(0x1, 0x7f)) {}
+      elemGen(config.elemGen.has_value() ? Generator<char>(config.elemGen.value()) : gen::interval<char>(0x1, 0x7f)),
+      asciiElemGen(!config.elemGen.has_value()) {}
 
 Shrinkable<string> Arbi<string>::operator()(Random& rand) const
 {
-    size_t size = rand.getRandomSize(minSize, maxSize + 1);
+    size_t size = rand.getRandomContainerSize(minSize, maxSize);
     string str(size, ' ' /*, allocator()*/);
-    for (size_t i = 0; i < size; i++)
-        str[i] = elemGen(rand).getRef();
+    if (asciiElemGen) {
+        uint32_t codes[64];
+        for (size_t done = 0; done < size;) {
+            const size_t n = size - done < 64 ? size - done : 64;
+            rand.fillUInt32(span<uint32_t>(codes, n), 0x1, 0x7f);
+            for (size_t i = 0; i < n; i++)
+                str[done + i] = static_cast<char>(codes[i]);
+            done += n;
+        }
+    } else {
+        for (size_t i = 0; i < size; i++)
+            str[i] = elemGen(rand).getRef();
+    }
 
     return shrinkString(str, minSize);
 }
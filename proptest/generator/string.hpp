@@ -37,6 +37,8 @@ public:
 
 private:
     Generator<char> elemGen;
+    /// elemGen is the default ASCII interval, so characters can be drawn in bulk without building Shrinkables
+    bool asciiElemGen;
 };
 
 }  // namespace proptest
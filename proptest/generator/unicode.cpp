@@ -19,4 +19,18 @@ Generator<uint32_t> unicode() {
 
 } // namespace gen
 
+namespace util {
+
+void fillUnicode(Random& rand, span<uint32_t> out)
+{
+    // uniform over U+0001..U+10FFFF without the surrogates U+D800..U+DFFF, which are skipped over
+    rand.fillUInt32(out, 0x1, 0x10FFFF - 0x800);
+    for (auto& code : out) {
+        if (code >= 0xD800)
+            code += 0x800;
+    }
+}
+
+} // namespace util
+
 }  // namespace proptest
@@ -12,4 +12,11 @@ PROPTEST_API Generator<uint32_t> unicode();
 
 } // namespace gen
 
+namespace util {
+
+/// Fills the buffer with code points from the same distribution as gen::unicode(), drawn in bulk
+PROPTEST_API void fillUnicode(Random& rand, span<uint32_t> out);
+
+} // namespace util
+
 }  // namespace proptest
@@ -9,13 +9,14 @@ namespace proptest {
 size_t Arbi<UTF16BEString>::defaultMinSize = 0;
 size_t Arbi<UTF16BEString>::defaultMaxSize = 200;
 
-Arbi<UTF16BEString>::Arbi(size_t _minSize, size_t _maxSize) : ArbiContainer(_minSize, _maxSize), elemGen(gen::unicode()) {}
+Arbi<UTF16BEString>::Arbi(size_t _minSize, size_t _maxSize) : ArbiContainer(_minSize, _maxSize), elemGen(gen::unicode()), unicodeElemGen(true) {}
 
-Arbi<UTF16BEString>::Arbi(GenFunction<uint32_t> _elemGen, size_t _minSize, size_t _maxSize) : ArbiContainer(_minSize, _maxSize), elemGen(_elemGen) {}
+Arbi<UTF16BEString>::Arbi(GenFunction<uint32_t> _elemGen, size_t _minSize, size_t _maxSize) : ArbiContainer(_minSize, _maxSize), elemGen(_elemGen), unicodeElemGen(false) {}
 
 Arbi<UTF16BEString>::Arbi(const util::ContainerGenConfig<uint32_t>& config)
     : ArbiContainer(config.minSize.value_or(defaultMinSize), config.maxSize.value_or(defaultMaxSize)),
-      elemGen(config.elemGen.value_or(gen::unicode())) {}
+      elemGen(config.elemGen.value_or(gen::unicode())),
+      unicodeElemGen(!config.elemGen.has_value()) {}
 
 /*
  * legal UTF-16 byte sequence
@@ -29,7 +30,7 @@ Arbi<UTF16BEString>::Arbi(const util::ContainerGenConfig<uint32_t>& config)
  */
 Shrinkable<UTF16BEString> Arbi<UTF16BEString>::operator()(Random& rand) const
 {
-    size_t len = rand.getRandomSize(minSize, maxSize + 1);
+    size_t len = rand.getRandomContainerSize(minSize, maxSize);
     vector<uint8_t> chars /*, allocator()*/;
     vector<int> positions /*, allocator()*/;
     vector<uint32_t> codes;
@@ -40,12 +41,16 @@ Shrinkable<UTF16BEString> Arbi<UTF16BEString>::operator()(Random& rand) const
 
     // cout << "UTF16 BE gen, len = " << len << endl;
 
-    for (size_t i = 0; i < len; i++) {
+    if (unicodeElemGen) {
+        codes.resize(len);
+        util::fillUnicode(rand, codes);
+    } else {
         // U+D800..U+DFFF is forbidden for surrogate use
-        Shrinkable<uint32_t> codeShr = elemGen(rand);
-        uint32_t code = codeShr.getRef();
+        for (size_t i = 0; i < len; i++)
+            codes.push_back(elemGen(rand).getRef());
+    }
+    for (uint32_t code : codes) {
         positions.push_back(chars.size());
-        codes.push_back(code);
         util::encodeUTF16BE(code, chars);
     }
     positions.push_back(chars.size());
@@ -72,13 +77,14 @@ Shrinkable<UTF16BEString> Arbi<UTF16BEString>::operator()(Random& rand) const
 size_t Arbi<UTF16LEString>::defaultMinSize = 0;
 size_t Arbi<UTF16LEString>::defaultMaxSize = 200;
 
-Arbi<UTF16LEString>::Arbi(size_t _minSize, size_t _maxSize) : ArbiContainer(_minSize, _maxSize), elemGen(gen::unicode()) {}
+Arbi<UTF16LEString>::Arbi(size_t _minSize, size_t _maxSize) : ArbiContainer(_minSize, _maxSize), elemGen(gen::unicode()), unicodeElemGen(true) {}
 
-Arbi<UTF16LEString>::Arbi(GenFunction<uint32_t> _elemGen, size_t _minSize, size_t _maxSize) : ArbiContainer(_minSize, _maxSize), elemGen(_elemGen) {}
+Arbi<UTF16LEString>::Arbi(GenFunction<uint32_t> _elemGen, size_t _minSize, size_t _maxSize) : ArbiContainer(_minSize, _maxSize), elemGen(_elemGen), unicodeElemGen(false) {}
 
 Arbi<UTF16LEString>::Arbi(const util::ContainerGenConfig<uint32_t>& config)
     : ArbiContainer(config.minSize.value_or(defaultMinSize), config.maxSize.value_or(defaultMaxSize)),
-      elemGen(config.elemGen.value_or(gen::unicode())) {}
+      elemGen(config.elemGen.value_or(gen::unicode())),
+      unicodeElemGen(!config.elemGen.has_value()) {}
 
 
 /*
@@ -93,7 +99,7 @@ Arbi<UTF16LEString>::Arbi(const util::ContainerGenConfig<uint32_t>& config)
  */
 Shrinkable<UTF16LEString> Arbi<UTF16LEString>::operator()(Random& rand) const
 {
-    size_t len = rand.getRandomSize(minSize, maxSize + 1);
+    size_t len = rand.getRandomContainerSize(minSize, maxSize);
     vector<uint8_t> chars /*, allocator()*/;
     vector<int> positions /*, allocator()*/;
     vector<uint32_t> codes;
@@ -104,12 +110,16 @@ Shrinkable<UTF16LEString> Arbi<UTF16LEString>::operator()(Random& rand) const
 
     // cout << "UTF16 LE gen, len = " << len << endl;
 
-    for (size_t i = 0; i < len; i++) {
+    if (unicodeElemGen) {
+        codes.resize(len);
+        util::fillUnicode(rand, codes);
+    } else {
         // U+D800..U+DFFF is forbidden for surrogate use
-        Shrinkable<uint32_t> codeShr = elemGen(rand);
-        uint32_t code = codeShr.getRef();
+        for (size_t i = 0; i < len; i++)
+            codes.push_back(elemGen(rand).getRef());
+    }
+    for (uint32_t code : codes) {
         positions.push_back(chars.size());
-        codes.push_back(code);
         util::encodeUTF16LE(code, chars);
     }
     positions.push_back(chars.size());
@@ -9,15 +9,16 @@ namespace proptest {
 size_t Arbi<UTF8String>::defaultMinSize = 0;
 size_t Arbi<UTF8String>::defaultMaxSize = 200;
 
-Arbi<UTF8String>::Arbi(size_t _minSize, size_t _maxSize) : ArbiContainer<UTF8String>(_minSize, _maxSize), elemGen(gen::unicode()) {}
+Arbi<UTF8String>::Arbi(size_t _minSize, size_t _maxSize) : ArbiContainer<UTF8String>(_minSize, _maxSize), elemGen(gen::unicode()), unicodeElemGen(true) {}
 
-Arbi<UTF8String>::Arbi(GenFunction<uint32_t> _elemGen, size_t _minSize, size_t _maxSize) : ArbiContainer<UTF8String>(_minSize, _maxSize), elemGen(_elemGen) {}
+Arbi<UTF8String>::Arbi(GenFunction<uint32_t> _elemGen, size_t _minSize, size_t _maxSize) : ArbiContainer<UTF8String>(_minSize, _maxSize), elemGen(_elemGen), unicodeElemGen(false) {}
 
 Arbi<UTF8String>::Arbi(const util::ContainerGenConfig<uint32_t>& config)
     : ArbiContainer<UTF8String>(
           config.minSize.value_or(defaultMinSize),
           config.maxSize.value_or(defaultMaxSize)),
-      elemGen(config.elemGen.value_or(gen::unicode())) {}
+      elemGen(config.elemGen.value_or(gen::unicode())),
+      unicodeElemGen(!config.elemGen.has_value()) {}
 /*
  * legal utf-8 byte sequence
  * http://www.unicode.org/versions/Unicode6.0.0/ch03.pdf
@@ -35,7 +36,7 @@ Arbi<UTF8String>::Arbi(const util::ContainerGenConfig<uint32_t>& config)
  */
 Shrinkable<UTF8String> Arbi<UTF8String>::operator()(Random& rand) const
 {
-    size_t len = rand.getRandomSize(minSize, maxSize + 1);
+    size_t len = rand.getRandomContainerSize(minSize, maxSize);
     vector<uint8_t> chars /*, allocator()*/;
     vector<int> positions /*, allocator()*/;
     vector<uint32_t> codes;
@@ -46,14 +47,16 @@ Shrinkable<UTF8String> Arbi<UTF8String>::operator()(Random& rand) const
 
     // cout << "utf8 gen, len = " << len << endl;
 
-    for (size_t i = 0; i < len; i++) {
+    if (unicodeElemGen) {
+        codes.resize(len);
+        util::fillUnicode(rand, codes);
+    } else {
         // U+D800..U+DFFF is forbidden for surrogate use
-        Shrinkable<uint32_t> codeShr = elemGen(rand);
-        uint32_t code = codeShr.getRef();
-
+        for (size_t i = 0; i < len; i++)
+            codes.push_back(elemGen(rand).getRef());
+    }
+    for (uint32_t code : codes) {
         positions.push_back(chars.size());
-        codes.push_back(code);
-
         util::encodeUTF8(code, chars);
     }
     positions.push_back(chars.size());
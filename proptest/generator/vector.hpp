@@ -4,6 +4,8 @@
 #include "proptest/generator/container_config.hpp"
 #include "proptest/Random.hpp"
 #include "proptest/shrinker/listlike.hpp"
+#include "proptest/shrinker/compactvector.hpp"
+#include "proptest/generator/integral.hpp"
 #include "proptest/std/vector.hpp"
 
 
@@ -27,9 +29,9 @@ public:
     static size_t defaultMinSize;
     static size_t defaultMaxSize;
 
-    Arbi(size_t _minSize = defaultMinSize, size_t _maxSize = defaultMaxSize) : ArbiContainer<vector<T>>(_minSize, _maxSize), elemGen(Arbi<T>()) {}
+    Arbi(size_t _minSize = defaultMinSize, size_t _maxSize = defaultMaxSize) : ArbiContainer<vector<T>>(_minSize, _maxSize), elemGen(Arbi<T>()), arbiElemGen(true) {}
 
-    Arbi(GenFunction<T> _elemGen, size_t _minSize = defaultMinSize, size_t _maxSize = defaultMaxSize) : ArbiContainer<vector<T>>(_minSize, _maxSize), elemGen(_elemGen) {}
+    Arbi(GenFunction<T> _elemGen, size_t _minSize = defaultMinSize, size_t _maxSize = defaultMaxSize) : ArbiContainer<vector<T>>(_minSize, _maxSize), elemGen(_elemGen), arbiElemGen(false) {}
 
     /**
      * @brief Constructor with named parameters (C++20 designated initializers)
@@ -39,17 +41,27 @@ public:
         : ArbiContainer<vector<T>>(
               config.minSize.value_or(defaultMinSize),
               config.maxSize.value_or(defaultMaxSize)),
-          elemGen(config.elemGen.value_or(Arbi<T>())) {}
+          elemGen(config.elemGen.value_or(Arbi<T>())), arbiElemGen(!config.elemGen.has_value()) {}
 
     Arbi setElemGen(GenFunction<T> _elemGen)
     {
         elemGen = _elemGen;
+        arbiElemGen = false;
         return *this;
     }
 
     Shrinkable<vector<T>> operator()(Random& rand) const override
     {
-        size_t size = rand.getRandomSize(minSize, maxSize + 1);
+        size_t size = rand.getRandomContainerSize(minSize, maxSize);
+        if constexpr (util::CompactElement<T>) {
+            // same values as Arbi<T>, held contiguously instead of one Shrinkable per element
+            if (arbiElemGen) {
+                auto vec = util::make_unique<vector<T>>(size);
+                for (auto& value : *vec)
+                    value = util::generateIntegerValue<T>(rand);
+                return shrinkCompactVector<T>(Shrinkable<vector<T>>(util::make_any<vector<T>>(util::move(vec))), minSize);
+            }
+        }
         auto shrinkVec = make_shrinkable<vector<ShrinkableBase>>();
         shrinkVec.getMutableRef().reserve(size);
         for (size_t i = 0; i < size; i++)
@@ -60,6 +72,8 @@ public:
 
 private:
     GenFunction<T> elemGen;
+    /// elemGen is Arbi<T>, so vectors of integers can be generated and shrunk as plain values
+    bool arbiElemGen;
 };
 
 template <typename T>
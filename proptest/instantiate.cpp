@@ -32,6 +32,7 @@ DEFINE_FOR_ALL_BASIC_TYPES(INSTANTIATE_SHRINKABLE);
 INSTANTIATE_SHRINKABLE(::proptest::vector<::proptest::ShrinkableBase>);
 
 DEFINE_FOR_ALL_BASIC_TYPES(INSTANTIATE_GENERATOR_FUNCTION);
+INSTANTIATE_GENERATOR_FUNCTION(::proptest::vector<::proptest::ShrinkableBase>);
 INSTANTIATE_FUNCTION(::proptest::ShrinkableBase(::proptest::Random&));
 
 DEFINE_FOR_ALL_BASIC_TYPES(INSTANTIATE_GENERATORBASE);
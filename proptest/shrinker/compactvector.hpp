@@ -0,0 +1,178 @@
+#pragma once
+#include "proptest/api.hpp"
+#include "proptest/Shrinkable.hpp"
+#include "proptest/shrinker/integral.hpp"
+#include "proptest/std/type.hpp"
+#include "proptest/std/vector.hpp"
+
+/**
+ * @file compactvector.hpp
+ * @brief Shrinking of vectors of integers held as plain values
+ *
+ * shrinkListLike() keeps a ShrinkableBase per element, each with its own Any and shrink closure, and copies all of
+ * them into every candidate. For integer elements shrinking towards 0, the shrinks of an element follow from its
+ * value and a search range, so a node only needs to hold the values and those ranges, and each candidate costs one
+ * contiguous copy. The candidates and their order are the same as with shrinkListLike().
+ */
+
+namespace proptest {
+
+namespace util {
+
+/// Integer types whose Arbi shrinks towards 0, so that element shrinks can be derived from the values alone
+template <typename T>
+concept CompactElement = is_same_v<T, char> || is_same_v<T, int8_t> || is_same_v<T, int16_t> ||
+                         is_same_v<T, int32_t> || is_same_v<T, int64_t> || is_same_v<T, uint8_t> ||
+                         is_same_v<T, uint16_t> || is_same_v<T, uint32_t> || is_same_v<T, uint64_t>;
+
+/**
+ * @brief Remaining shrinks of an integer, as shrinkIntegral() would produce them: 0 if zeroFirst, then a binary
+ * search within (lo, hi)
+ *
+ * A plain value, so that the shrink state of a whole vector can be copied in one go.
+ */
+template <CompactElement T>
+struct CompactShrinks
+{
+    T lo = 0;
+    T hi = 0;
+    bool zeroFirst = false;
+
+    /// shrinks of a generated value
+    static CompactShrinks of(T value)
+    {
+        if (value == 0)
+            return CompactShrinks{};
+        else if (value > 0)
+            return CompactShrinks{0, value, true};
+        else
+            return CompactShrinks{value, 0, true};
+    }
+
+    bool isEmpty() const { return !zeroFirst && !(lo < hi && lo + 1 < hi); }
+
+    /// removes the first shrink and returns it, with its own shrinks written to headShrinks
+    T pop(CompactShrinks& headShrinks)
+    {
+        if (zeroFirst) {
+            zeroFirst = false;
+            headShrinks = CompactShrinks{};
+            return 0;
+        }
+        const bool bothOdd = lo % 2 != 0 && hi % 2 != 0;
+        if (hi > 0) {
+            // towards 0 from above: [0, mid] is searched under mid, (mid, hi) after it
+            T mid = static_cast<T>(lo / 2 + hi / 2 + (bothOdd ? 1 : 0));
+            headShrinks = CompactShrinks{lo, mid, false};
+            lo = mid;
+            return mid;
+        } else {
+            T mid = static_cast<T>(lo / 2 + hi / 2 + (bothOdd ? -1 : 0));
+            headShrinks = CompactShrinks{mid, hi, false};
+            hi = mid;
+            return mid;
+        }
+    }
+};
+
+/**
+ * @brief Element-wise shrinks of a vector: every element with shrinks left moves to its next shrink at once
+ *
+ * Same search as the bulk shrinking of shrinkListLike(). Each candidate holds the values and the shrinks of each
+ * value, both contiguous; an element whose shrinks are used up falls back to its value in the ancestor.
+ *
+ * @param ancestor vector whose elements are being shrunk
+ * @param ancestorShrinks shrinks of each element of ancestor
+ * @param remaining shrinks of each element not tried yet
+ */
+template <CompactElement T>
+typename Shrinkable<vector<T>>::StreamType shrinkCompactBulk(const Shrinkable<vector<T>>& ancestor,
+                                                               const shared_ptr<vector<CompactShrinks<T>>>& ancestorShrinks,
+                                                               const shared_ptr<vector<CompactShrinks<T>>>& remaining)
+{
+    using shrinkable_t = Shrinkable<vector<T>>;
+    using stream_t = typename shrinkable_t::StreamType;
+    using stream_element_t = typename shrinkable_t::StreamElementType;
+
+    const vector<T>& ancestorVec = ancestor.getRef();
+    const size_t size = ancestorVec.size();
+    auto newVec = util::make_unique<vector<T>>(ancestorVec);
+    auto newShrinks = util::make_shared<vector<CompactShrinks<T>>>(*ancestorShrinks);
+    auto newRemaining = util::make_shared<vector<CompactShrinks<T>>>(*remaining);
+
+    bool nothingToDo = true;
+    for (size_t i = 0; i < size; i++) {
+        CompactShrinks<T>& elemRemaining = (*newRemaining)[i];
+        if (!elemRemaining.isEmpty()) {
+            (*newVec)[i] = elemRemaining.pop((*newShrinks)[i]);
+            nothingToDo = false;
+        }
+    }
+    if (nothingToDo)
+        return stream_t::empty();
+
+    shrinkable_t newShrinkable(util::make_any<vector<T>>(util::move(newVec)));
+    newShrinkable = newShrinkable.with([newShrinkable, newShrinks]() -> stream_t {
+        return shrinkCompactBulk<T>(newShrinkable, newShrinks, newShrinks);
+    });
+    return stream_t(stream_element_t(newShrinkable), [ancestor, ancestorShrinks, newRemaining]() -> stream_t {
+        return shrinkCompactBulk<T>(ancestor, ancestorShrinks, newRemaining);
+    });
+}
+
+/// element-wise shrinks of a vector of generated values
+template <CompactElement T>
+typename Shrinkable<vector<T>>::StreamType shrinkCompactElementwise(const Shrinkable<vector<T>>& parent)
+{
+    const vector<T>& vec = parent.getRef();
+    auto shrinks = util::make_shared<vector<CompactShrinks<T>>>();
+    shrinks->reserve(vec.size());
+    for (const T& value : vec)
+        shrinks->push_back(CompactShrinks<T>::of(value));
+    return shrinkCompactBulk<T>(parent, shrinks, shrinks);
+}
+
+/**
+ * @brief Membership-wise shrinks of a vector: removes as much of the front as possible while keeping the last
+ * rearSize elements, then fixes one more element to the rear (same search as shrinkListLike())
+ */
+template <CompactElement T>
+Shrinkable<vector<T>> shrinkCompactFrontAndThenMid(const Shrinkable<vector<T>>& shr, size_t minSize, size_t rearSize)
+{
+    const size_t size = shr.getRef().size();
+    const size_t minFrontSize = minSize >= rearSize ? minSize - rearSize : 0;
+    const size_t maxFrontSize = size - rearSize;
+    return shrinkIntegral<size_t>(maxFrontSize - minFrontSize)
+        .template flatMap<vector<T>>([shr, minFrontSize, maxFrontSize](const size_t& s) {
+            const size_t frontSize = s + minFrontSize;
+            const vector<T>& vec = shr.getRef();
+            auto newVec = util::make_unique<vector<T>>();
+            newVec->reserve(frontSize + vec.size() - maxFrontSize);
+            newVec->insert(newVec->end(), vec.begin(), vec.begin() + frontSize);
+            newVec->insert(newVec->end(), vec.begin() + maxFrontSize, vec.end());
+            return Shrinkable<vector<T>>(util::make_any<vector<T>>(util::move(newVec)));
+        })
+        .concat([minSize, rearSize](const Shrinkable<vector<T>>& parent) {
+            const size_t parentSize = parent.getRef().size();
+            if (parentSize <= minSize || parentSize <= rearSize)
+                return Shrinkable<vector<T>>::StreamType::empty();
+            return shrinkCompactFrontAndThenMid<T>(parent, minSize, rearSize + 1).getShrinks();
+        });
+}
+
+}  // namespace util
+
+/**
+ * @brief Membership-wise and then element-wise shrinking of a vector of integers, like shrinkListLike()
+ *
+ * @param shr vector to shrink
+ * @param minSize minimum size a shrunk vector can be
+ */
+template <util::CompactElement T>
+Shrinkable<vector<T>> shrinkCompactVector(const Shrinkable<vector<T>>& shr, size_t minSize)
+{
+    return util::shrinkCompactFrontAndThenMid<T>(shr, minSize, 0)
+        .andThen([](const Shrinkable<vector<T>>& parent) { return util::shrinkCompactElementwise<T>(parent); });
+}
+
+}  // namespace proptest
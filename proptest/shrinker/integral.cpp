@@ -6,92 +6,74 @@
 namespace proptest {
 namespace util {
 
+// every node holds (its search value + offset), so that a shifted range needs no map() over the tree
 template <typename T>
-Shrinkable<T> binarySearchShrinkableImpl(T value);
-template <typename T>
-Shrinkable<T> binarySearchShrinkableImpl(T value);
-
-template <typename T>
-Shrinkable<T> binarySearchShrinkableImpl(T value)
+Shrinkable<T> binarySearchShrinkableImpl(T value, T offset = 0)
 {
     using stream_t = typename Shrinkable<T>::StreamType;
     using elem_t = typename Shrinkable<T>::StreamElementType;
-    using genfunc_t = Function<stream_t(T, T)>;
+    using genfunc_t = Function<stream_t(T, T, T)>;
 
     // given min, max, generate stream
-    static genfunc_t genpos = +[](T min, T max) -> stream_t {
+    static genfunc_t genpos = +[](T min, T max, T off) -> stream_t {
         T mid = static_cast<T>(min / 2 + max / 2 + ((min % 2 != 0 && max % 2 != 0) ? 1 : 0));
 
         if (min + 1 >= max) {
             return stream_t::empty();
         } else if (min + 2 >= max) {
-            return stream_t::template one<elem_t>(make_shrinkable<T>(mid));
+            return stream_t::template one<elem_t>(make_shrinkable<T>(static_cast<T>(mid + off)));
         } else
-            return stream_t(elem_t(Shrinkable<T>(util::make_any<T>(mid), [=]() -> stream_t { return genpos(min, mid); })),
-                            [=]() -> stream_t { return genpos(mid, max); });
+            return stream_t(elem_t(Shrinkable<T>(util::make_any<T>(static_cast<T>(mid + off)), [=]() -> stream_t { return genpos(min, mid, off); })),
+                            [=]() -> stream_t { return genpos(mid, max, off); });
     };
 
-    static genfunc_t genneg = +[](T min, T max) -> stream_t {
+    static genfunc_t genneg = +[](T min, T max, T off) -> stream_t {
         int64_t mid = static_cast<T>(min / 2 + max / 2 + ((min % 2 != 0 && max % 2 != 0) ? -1 : 0));
 
         if (min + 1 >= max) {
             return stream_t::empty();
         } else if (min + 2 >= max) {
-            return stream_t::template one<elem_t>(make_shrinkable<T>(mid));
+            return stream_t::template one<elem_t>(make_shrinkable<T>(static_cast<T>(mid + off)));
         } else
-            return stream_t(elem_t(Shrinkable<T>(util::make_any<T>(mid), [=]() -> stream_t { return genneg(mid, max); })),
-                            [=]() -> stream_t { return genneg(min, mid); });
+            return stream_t(elem_t(Shrinkable<T>(util::make_any<T>(static_cast<T>(mid + off)), [=]() -> stream_t { return genneg(static_cast<T>(mid), max, off); })),
+                            [=]() -> stream_t { return genneg(min, static_cast<T>(mid), off); });
     };
 
-    return Shrinkable<T>(util::make_any<T>(value), [value]() {
+    return Shrinkable<T>(util::make_any<T>(static_cast<T>(value + offset)), [value, offset]() {
         if (value == 0)
             return stream_t::empty();
         else if (value > 0)
-            return stream_t::template one<elem_t>(make_shrinkable<T>(0)).concat(genpos(0, value));
+            return stream_t::template one<elem_t>(make_shrinkable<T>(offset)).concat(genpos(0, value, offset));
         else
-            return stream_t::template one<elem_t>(make_shrinkable<T>(0)).concat(genneg(value, 0));
+            return stream_t::template one<elem_t>(make_shrinkable<T>(offset)).concat(genneg(value, 0, offset));
     });
 }
 
 template <typename T>
-Shrinkable<T> binarySearchShrinkableUImpl(T value)
+Shrinkable<T> binarySearchShrinkableUImpl(T value, T offset = 0)
 {
     using stream_t = typename Shrinkable<T>::StreamType;
     using elem_t = typename Shrinkable<T>::StreamElementType;
-    using genfunc_t = Function<stream_t(T, T)>;
+    using genfunc_t = Function<stream_t(T, T, T)>;
 
     // given min, max, generate stream
-    static genfunc_t genpos = +[](T min, T max) {
+    static genfunc_t genpos = +[](T min, T max, T off) {
         T mid = static_cast<T>(min / 2 + max / 2 + ((min % 2 != 0 && max % 2 != 0) ? 1 : 0));
 
         if (min + 1 >= max) {
             return stream_t::empty();
         } else if (min + 2 >= max) {
-            return stream_t::template one<elem_t>(make_shrinkable<T>(mid));
-        } else
-            return stream_t(elem_t(Shrinkable<T>(util::make_any<T>(mid), [=]() { return genpos(min, mid); })),
-                            [=]() { return genpos(mid, max); });
-    };
-
-    static genfunc_t genneg = +[](T min, T max) {
-        T mid = (min % 2 != 0 && max % 2 != 0) ? (min / 2 + max / 2 - 1) : (min / 2 + max / 2);
-
-        if (min + 1 >= max) {
-            return stream_t::empty();
-        } else if (min + 2 >= max) {
-            return stream_t::template one<elem_t>(make_shrinkable<T>(mid));
+            return stream_t::template one<elem_t>(make_shrinkable<T>(static_cast<T>(mid + off)));
         } else
-            return stream_t(elem_t(Shrinkable<T>(util::make_any<T>(mid), [=]() { return genneg(mid, max); })),
-                            [=]() { return genneg(min, mid); });
+            return stream_t(elem_t(Shrinkable<T>(util::make_any<T>(static_cast<T>(mid + off)), [=]() { return genpos(min, mid, off); })),
+                            [=]() { return genpos(mid, max, off); });
     };
 
-    return Shrinkable<T>(util::make_any<T>(value), [value]() {
+    return Shrinkable<T>(util::make_any<T>(static_cast<T>(value + offset)), [value, offset]() {
         if (value == 0)
             return stream_t::empty();
-        else if (value > 0)
-            return stream_t::template one<elem_t>(make_shrinkable<T>(0U)).concat(genpos(0U, value));
         else
-            return stream_t::template one<elem_t>(make_shrinkable<T>(0U)).concat(genneg(value, 0U));
+            return stream_t::template one<elem_t>(make_shrinkable<T>(offset)).concat(genpos(0U, value, offset));
     });
 }
 
@@ -103,6 +85,21 @@ Shrinkable<uint64_t> binarySearchShrinkableU(uint64_t value) {
     return binarySearchShrinkableUImpl<uint64_t>(value);
 }
 
+template <typename T>
+    requires is_integral_v<T>
+Shrinkable<T> binarySearchShrinkableWithOffset(T value, T offset)
+{
+    if constexpr(is_signed<T>::value)
+        return binarySearchShrinkableImpl<T>(value, offset);
+    else
+        return binarySearchShrinkableUImpl<T>(value, offset);
+}
+
+#define DEFINE_BINARY_SEARCH_SHRINKABLE_WITH_OFFSET(TYPE) \
+    template PROPTEST_API Shrinkable<TYPE> binarySearchShrinkableWithOffset<TYPE>(TYPE value, TYPE offset)
+
+DEFINE_FOR_ALL_INTTYPES(DEFINE_BINARY_SEARCH_SHRINKABLE_WITH_OFFSET);
+
 }  // namespace util
 
 
@@ -10,6 +10,16 @@ namespace util {
 PROPTEST_API Shrinkable<int64_t> binarySearchShrinkable(int64_t value);
 PROPTEST_API Shrinkable<uint64_t> binarySearchShrinkableU(uint64_t value);
 
+/**
+ * @brief Binary search shrinking of value towards 0, with offset added to the value of every node
+ *
+ * Equivalent to mapping binarySearchShrinkable(value) with `x + offset`, but the tree is built directly in T,
+ * without the per-node transformation layer of map(). Instantiated for all integral types in DEFINE_FOR_ALL_INTTYPES.
+ */
+template <typename T>
+    requires is_integral_v<T>
+PROPTEST_API Shrinkable<T> binarySearchShrinkableWithOffset(T value, T offset);
+
 }  // namespace util
 
 template <typename T> requires is_integral_v<T>
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "proptest/shrinker/bool.hpp"
+#include "proptest/shrinker/compactvector.hpp"
 #include "proptest/shrinker/floating.hpp"
 #include "proptest/shrinker/integral.hpp"
 #include "proptest/shrinker/listlike.hpp"
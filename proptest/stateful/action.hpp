@@ -4,6 +4,10 @@
 #include "proptest/std/string.hpp"
 #include "proptest/std/io.hpp"
 #include "proptest/std/variant.hpp"
+#include "proptest/std/memory.hpp"
+#include "proptest/std/tuple.hpp"
+#include "proptest/std/type.hpp"
+#include "proptest/std/lang.hpp"
 #include "proptest/stateful/context.hpp"
 
 /**
@@ -14,14 +18,113 @@
 namespace proptest {
 namespace stateful {
 
-template<typename ARG0, typename...ARGS>
-auto makeActionName(const char* name, ARG0&& arg0, ARGS&&...args) {
-    stringstream str;
-    str << name << "(";
-    str << arg0;
-    ((str << "," << args), ...);  // C++17 fold expression
-    str << ")";
-    return str.str();
+/// formats an action name on demand
+struct ActionNameFormat
+{
+    virtual ~ActionNameFormat() {}
+    virtual void print(ostream& os) const = 0;
+};
+
+/// name(arg0,arg1,...), where NAME is either const char* for a string literal or string
+template <typename NAME, typename... ARGS>
+struct ActionNameWithArgs : public ActionNameFormat
+{
+    template <typename N, typename... AS>
+    ActionNameWithArgs(N&& _name, AS&&... _args) : name(util::forward<N>(_name)), args(util::forward<AS>(_args)...)
+    {
+    }
+
+    void print(ostream& os) const override
+    {
+        os << name << "(";
+        util::apply(
+            [&os](const auto& arg0, const auto&... rest) {
+                os << arg0;
+                ((os << "," << rest), ...);
+            },
+            args);
+        os << ")";
+    }
+
+    NAME name;
+    tuple<ARGS...> args;
+};
+
+/**
+ * @brief Description of an action, formatted only when it is printed
+ *
+ * Actions are generated and copied on every run, while their names are only needed to report a failure. An ActionName
+ * therefore keeps what to print rather than the printed string. A string literal is kept by pointer and other text
+ * by value, so plain names cost no allocation beyond the string's own; names with arguments are shared by copies.
+ */
+class ActionName {
+public:
+    ActionName() : name(static_cast<const char*>("")) {}
+    /// a string literal (or other array of static storage), kept by pointer
+    template <size_t N>
+    ActionName(const char (&text)[N]) : name(static_cast<const char*>(text))
+    {
+    }
+    /// a mutable array may change or go away before the name is printed, so it is copied
+    template <size_t N>
+    ActionName(char (&text)[N]) : name(string(text))
+    {
+    }
+    template <typename T>
+        requires(is_same_v<T, const char*> || is_same_v<T, char*>)
+    ActionName(const T& text) : name(string(text))
+    {
+    }
+    ActionName(string text) : name(util::move(text)) {}
+    explicit ActionName(shared_ptr<const ActionNameFormat> format) : name(util::move(format)) {}
+
+    string str() const
+    {
+        stringstream os;
+        os << *this;
+        return os.str();
+    }
+
+    operator string() const { return str(); }
+
+    friend ostream& operator<<(ostream& os, const ActionName& actionName)
+    {
+        if (holds_alternative<const char*>(actionName.name))
+            os << get<const char*>(actionName.name);
+        else if (holds_alternative<string>(actionName.name))
+            os << get<string>(actionName.name);
+        else
+            get<shared_ptr<const ActionNameFormat>>(actionName.name)->print(os);
+        return os;
+    }
+
+private:
+    variant<const char*, string, shared_ptr<const ActionNameFormat>> name;
+};
+
+/**
+ * @brief How an action name part of type T is stored: a const character array is taken to be a string literal and is
+ * kept by pointer, other character arrays and pointers are copied to a string, and anything else is kept as decay_t<T>
+ */
+template <typename T>
+using ActionNameStored_t = conditional_t<
+    is_array_v<remove_reference_t<T>> && is_const_v<remove_extent_t<remove_reference_t<T>>>, const char*,
+    conditional_t<is_same_v<decay_t<T>, const char*> || is_same_v<decay_t<T>, char*>, string, decay_t<T>>>;
+
+/**
+ * @brief Name of an action with arguments, printed as name(arg0,arg1,...)
+ *
+ * Nothing is formatted here: the arguments are copied and printed with operator<< once the name is shown. The name
+ * and any text arguments are stored as ActionNameStored_t describes, so a buffer or a c_str() that changes or goes
+ * away before the name is printed is not read again.
+ */
+template <typename NAME, typename ARG0, typename... ARGS>
+ActionName makeActionName(NAME&& name, ARG0&& arg0, ARGS&&... args)
+{
+    using name_t = conditional_t<is_same_v<ActionNameStored_t<NAME>, const char*>, const char*, string>;
+    return ActionName(
+        util::make_shared<ActionNameWithArgs<name_t, ActionNameStored_t<ARG0>, ActionNameStored_t<ARGS>...>>(
+            util::forward<NAME>(name), util::forward<ARG0>(arg0), util::forward<ARGS>(args)...));
 }
 
 #define PROP_ACTION_NAME(name, ...) proptest::stateful::makeActionName(name, ##__VA_ARGS__)
@@ -37,7 +140,7 @@ struct SimpleAction {
     using function_with_context_t = Function<void(ObjectType&, Context&)>;
     explicit SimpleAction(function_t f) : name("Action<?>"), func(f) {}
 
-    SimpleAction(const string& _name, function_t f) : name(_name), func(f) {}
+    SimpleAction(const ActionName& _name, function_t f) : name(_name), func(f) {}
 
     void operator()(ObjectType& obj) const {
         func(obj);
@@ -48,7 +151,7 @@ struct SimpleAction {
         return os;
     }
 
-    string name;
+    ActionName name;
     function_t func;
 };
 
@@ -58,7 +161,12 @@ struct Action {
     using function_with_context_t = Function<void(ObjectType&, ModelType&, Context&)>;
     explicit Action(function_t f) : name("Action<?>"), func(f) {}
 
-    Action(const string& _name, function_t f) : name(_name), func(f) {}
+    Action(const ActionName& _name, function_t f) : name(_name), func(f) {}
+
+    /// action that is given the Context of the thread running it
+    explicit Action(function_with_context_t f) : name("Action<?>"), func(f) {}
+
+    Action(const ActionName& _name, function_with_context_t f) : name(_name), func(f) {}
 
     Action(const SimpleAction<ObjectType>& simpleAction) : name(simpleAction.name) {
         func = static_cast<function_t>([simpleAction](ObjectType& obj, ModelType&) {
@@ -88,7 +196,7 @@ struct Action {
         return os;
     }
 
-    string name;
+    ActionName name;
     variant<function_t, function_with_context_t> func;
 };
 
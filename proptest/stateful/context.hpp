@@ -1,11 +1,38 @@
 #pragma once
 
+#include "proptest/util/function.hpp"
+
 namespace proptest {
 namespace stateful {
 
+/**
+ * @brief What an action knows about the run it is part of
+ *
+ * An action that takes a Context can call linearize() to take part in the linearizability check of a concurrent run
+ * (see StatefulProperty::setLinearizabilityCheck()).
+ */
 struct Context
 {
     int threadId;
+    /// step of the call that linearize() was last given, taken by the run once the action returns
+    Function<bool(void*)> linearization;
+    /// partition of that call; calls of different partitions are checked separately
+    uint64_t partition = 0;
+
+    /**
+     * @brief Describes the call the action is making, for the linearizability check
+     *
+     * @param step applies the call to a model and returns whether the result the action observed agrees with it
+     * @param key calls with different keys are independent of each other (e.g. operations on different keys of a
+     * map), so each key is checked on its own
+     */
+    template <typename ModelType>
+    void linearize(Function<bool(ModelType&)> step, uint64_t key = 0)
+    {
+        // the run knows ModelType, so only the pointer needs to be erased here
+        linearization = [step](void* model) { return step(*static_cast<ModelType*>(model)); };
+        partition = key;
+    }
 };
 
 } // namespace stateful
@@ -0,0 +1,311 @@
+#pragma once
+
+#include "proptest/stateful/action.hpp"
+#include "proptest/stateful/context.hpp"
+#include "proptest/util/assert.hpp"
+#include "proptest/std/algorithm.hpp"
+#include "proptest/std/concepts.hpp"
+#include "proptest/std/functional.hpp"
+#include "proptest/std/io.hpp"
+#include "proptest/std/limits.hpp"
+#include "proptest/std/map.hpp"
+#include "proptest/std/set.hpp"
+#include "proptest/std/string.hpp"
+#include "proptest/std/type.hpp"
+#include "proptest/std/vector.hpp"
+#include <atomic>
+
+/**
+ * @file linearizability.hpp
+ * @brief Checks that the calls of a concurrent run can be put in a sequential order the model allows
+ *
+ * A call is linearizable if it appears to take effect at one instant between its invocation and its response. A
+ * history of calls is checked by searching for a sequential order that keeps every call's real-time order (a call
+ * that responded before another was invoked comes first) and in which each call's observed result agrees with the
+ * model (Wing & Gong, with the memoization of Lowe). A search state is the set of calls already linearized plus the
+ * model state they lead to; when ModelType can be compared and hashed, states found to be dead ends are remembered,
+ * up to a memory bound, and not explored again.
+ */
+
+namespace proptest {
+namespace stateful {
+
+/// model types whose states the linearizability search can remember
+template <typename ModelType>
+concept MemoizableModel = requires(const ModelType& a, const ModelType& b) {
+    { a == b } -> convertible_to<bool>;
+    { hash<ModelType>{}(a) } -> convertible_to<size_t>;
+};
+
+/// a completed call of a concurrent run
+template <typename ModelType>
+struct LinearizableCall
+{
+    int threadId;
+    /// logical time of invocation and response, from the same clock for all threads
+    uint64_t invokedAt;
+    uint64_t respondedAt;
+    ActionName name;
+    uint64_t partition;
+    /// applies the call to a model, returning whether the observed result agrees with it
+    Function<bool(ModelType&)> step;
+};
+
+enum class Linearizability {
+    Linearizable,
+    NotLinearizable,
+    /// the search ran out of its state budget before finding an order or ruling all of them out
+    Inconclusive
+};
+
+/**
+ * @brief Calls of the front and the rear threads of a concurrent run, recorded without locking
+ *
+ * Each thread appends to a slot of its own; invocations and responses are ordered by a shared atomic clock.
+ */
+template <typename ModelType>
+class LinearizabilityHistory {
+public:
+    using Call = LinearizableCall<ModelType>;
+
+    /// history of the front and numRears rear threads, run on a system in the state of initialModel
+    LinearizabilityHistory(size_t numRears, const ModelType& _initialModel)
+        : initialModel(_initialModel), slots(numRears + 1)
+    {
+    }
+
+    const ModelType& getInitialModel() const { return initialModel; }
+
+    /// logical time of an invocation or a response
+    uint64_t tick() { return clock.fetch_add(1); }
+
+    /**
+     * @brief Records the call the thread of context has just returned from, if its action called
+     * Context::linearize(), and clears it from context
+     */
+    void record(Context& context, uint64_t invokedAt, const ActionName& name)
+    {
+        const uint64_t respondedAt = tick();
+        if (!context.linearization)
+            return;
+        Function<bool(void*)> erased = context.linearization;
+        context.linearization = {};
+        // the front has thread id -1
+        slots[static_cast<size_t>(context.threadId + 1)].push_back(
+            Call{context.threadId, invokedAt, respondedAt, name, context.partition,
+                 [erased](ModelType& model) { return erased(&model); }});
+    }
+
+    /// recorded calls of all threads; only to be called once the threads are done
+    vector<Call> getCalls() const
+    {
+        vector<Call> calls;
+        for (const auto& slot : slots)
+            calls.insert(calls.end(), slot.begin(), slot.end());
+        return calls;
+    }
+
+private:
+    ModelType initialModel;
+    std::atomic<uint64_t> clock{0};
+    vector<vector<Call>> slots;
+};
+
+/**
+ * @brief Searches for a linearization of a history of calls
+ *
+ * Calls of different partitions are independent (P-compositionality), so each partition is searched on its own,
+ * starting from the same initial model. This keeps the search small when calls touch disjoint parts of the state.
+ */
+template <typename ModelType>
+class LinearizabilityChecker {
+public:
+    using Call = LinearizableCall<ModelType>;
+    static constexpr uint64_t defaultMaxStates = 1000000;
+    static constexpr size_t defaultMaxMemoBytes = 64 * 1024 * 1024;
+
+    /**
+     * @param _maxStates search states to explore before the result is inconclusive
+     * @param _maxMemoBytes memory for remembering dead ends, estimated from sizeof(ModelType) (memory a model holds
+     * on the heap is not counted); once it is used up, new dead ends are not remembered and the search goes on
+     * without them
+     */
+    explicit LinearizabilityChecker(uint64_t _maxStates = defaultMaxStates, size_t _maxMemoBytes = defaultMaxMemoBytes)
+        : maxStates(_maxStates), maxMemoBytes(_maxMemoBytes)
+    {
+    }
+
+    Linearizability check(const ModelType& initial, const vector<Call>& calls)
+    {
+        numStates = 0;
+        failedCalls.clear();
+        map<uint64_t, vector<const Call*>> partitions;
+        for (const auto& call : calls)
+            partitions[call.partition].push_back(&call);
+
+        bool inconclusive = false;
+        for (auto& [key, partCalls] : partitions) {
+            util::sort(partCalls.begin(), partCalls.end(),
+                       [](const Call* a, const Call* b) { return a->invokedAt < b->invokedAt; });
+            const Linearizability result = checkPartition(initial, partCalls);
+            if (result == Linearizability::NotLinearizable) {
+                for (const Call* call : partCalls)
+                    failedCalls.push_back(*call);
+                return result;
+            }
+            if (result == Linearizability::Inconclusive)
+                inconclusive = true;
+        }
+        return inconclusive ? Linearizability::Inconclusive : Linearizability::Linearizable;
+    }
+
+    /// calls of the partition that could not be linearized by the last check(), in invocation order
+    const vector<Call>& getFailedCalls() const { return failedCalls; }
+
+    /// number of search states the last check() visited
+    uint64_t getNumStates() const { return numStates; }
+
+    static void printCalls(ostream& os, const vector<Call>& calls)
+    {
+        for (size_t i = 0; i < calls.size(); i++) {
+            const Call& call = calls[i];
+            if (i > 0)
+                os << ", ";
+            if (call.threadId < 0)
+                os << "front";
+            else
+                os << "thr" << call.threadId;
+            os << " " << call.name << " [" << call.invokedAt << ", " << call.respondedAt
+               << "]";
+        }
+    }
+
+private:
+    /// a set of linearized calls and the model state they lead to
+    struct SearchState
+    {
+        vector<uint64_t> linearized;
+        ModelType model;
+
+        bool operator==(const SearchState& other) const
+        {
+            return linearized == other.linearized && model == other.model;
+        }
+    };
+
+    struct SearchStateHash
+    {
+        size_t operator()(const SearchState& state) const
+        {
+            size_t h = hash<ModelType>{}(state.model);
+            for (uint64_t word : state.linearized)
+                h ^= hash<uint64_t>{}(word) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+
+    struct NoDeadEnds
+    {
+    };
+    using DeadEnds =
+        conditional_t<MemoizableModel<ModelType>, unordered_set<SearchState, SearchStateHash>, NoDeadEnds>;
+
+    Linearizability checkPartition(const ModelType& initial, const vector<const Call*>& partCalls)
+    {
+        calls = &partCalls;
+        linearized.assign((partCalls.size() + 63) / 64, 0);
+        numLinearized = 0;
+        exhausted = false;
+        deadEnds = DeadEnds{};
+        memoBytes = 0;
+        if (search(initial))
+            return Linearizability::Linearizable;
+        return exhausted ? Linearizability::Inconclusive : Linearizability::NotLinearizable;
+    }
+
+    bool isLinearized(size_t i) const { return (linearized[i / 64] >> (i % 64)) & 1; }
+
+    void flip(size_t i) { linearized[i / 64] ^= uint64_t(1) << (i % 64); }
+
+    /// whether the calls not linearized yet can be linearized, starting from model
+    bool search(const ModelType& model)
+    {
+        const vector<const Call*>& cs = *calls;
+        if (numLinearized == cs.size())
+            return true;
+        if constexpr (MemoizableModel<ModelType>) {
+            // a node of the set, with its bitset, plus its bucket
+            const size_t entryBytes = sizeof(SearchState) + linearized.size() * sizeof(uint64_t) + 4 * sizeof(void*);
+            if (memoBytes + entryBytes <= maxMemoBytes) {
+                if (!deadEnds.insert(SearchState{linearized, model}).second)
+                    return false;
+                memoBytes += entryBytes;
+            } else if (deadEnds.count(SearchState{linearized, model})) {
+                return false;
+            }
+        }
+        if (++numStates > maxStates) {
+            exhausted = true;
+            return false;
+        }
+
+        // a call can go next only if it was invoked before every pending call responded
+        uint64_t firstResponse = numeric_limits<uint64_t>::max();
+        for (size_t i = 0; i < cs.size(); i++) {
+            if (!isLinearized(i))
+                firstResponse = util::min(firstResponse, cs[i]->respondedAt);
+        }
+
+        for (size_t i = 0; i < cs.size() && cs[i]->invokedAt < firstResponse; i++) {
+            if (isLinearized(i))
+                continue;
+            ModelType next = model;
+            if (!cs[i]->step(next))
+                continue;
+            flip(i);
+            numLinearized++;
+            const bool found = search(next);
+            flip(i);
+            numLinearized--;
+            if (found)
+                return true;
+            if (exhausted)
+                return false;
+        }
+        return false;
+    }
+
+    uint64_t maxStates;
+    size_t maxMemoBytes;
+    uint64_t numStates = 0;
+    size_t memoBytes = 0;
+    vector<Call> failedCalls;
+
+    const vector<const Call*>* calls = nullptr;
+    vector<uint64_t> linearized;
+    size_t numLinearized = 0;
+    bool exhausted = false;
+    DeadEnds deadEnds;
+};
+
+/**
+ * @brief Throws AssertFailed if the calls recorded in history have no linearization
+ *
+ * An inconclusive search is not a failure.
+ */
+template <typename ModelType>
+void assertLinearizable(const LinearizabilityHistory<ModelType>& history,
+                        uint64_t maxStates = LinearizabilityChecker<ModelType>::defaultMaxStates)
+{
+    LinearizabilityChecker<ModelType> checker(maxStates);
+    if (checker.check(history.getInitialModel(), history.getCalls()) != Linearizability::NotLinearizable)
+        return;
+    stringstream str;
+    str << "not linearizable: no sequential order of the calls agrees with the model: ";
+    LinearizabilityChecker<ModelType>::printCalls(str, checker.getFailedCalls());
+    const string msg = str.str();
+    throw AssertFailed(__FILE__, __LINE__, {}, msg.c_str(), nullptr);
+}
+
+}  // namespace stateful
+}  // namespace proptest
@@ -63,6 +63,47 @@ Shrinkable<vector<ShrinkableBase>> genActionShrinkables(
     return actionShrinkables;
 }
 
+/**
+ * States reached by replaying the action prefixes of the last node whose PrefixParams shrinks were built.
+ *
+ * An accepted shrink changes one action of its parent, so the next node replayed shares the prefix in front of it
+ * and takes those states from here instead of replaying them from the initial state. Actions are told apart by the
+ * address of their pair<Random,Action>; holding the elements keeps those addresses from being reused.
+ */
+template <typename ObjectType, typename ModelType>
+struct PrefixCheckpoints
+{
+    using PairType = pair<Random, Action<ObjectType, ModelType>>;
+
+    PrefixCheckpoints(const Function<ObjectType(const ObjectType&)>& _cloneObject,
+                      const Function<ModelType(const ModelType&)>& _cloneModel)
+        : cloneObject(_cloneObject), cloneModel(_cloneModel)
+    {
+    }
+
+    /// copy of a model state, which replaying actions on can not change the stored one
+    ModelType snapshotModel(const ModelType& model) const { return cloneModel ? cloneModel(model) : model; }
+
+    /// drops the states of actions that differ from vec, keeping those of the common prefix
+    void truncateTo(const vector<ShrinkableBase>& vec)
+    {
+        size_t common = 0;
+        while (common < actions.size() && common < vec.size() &&
+               &actions[common].getAny().template getRef<PairType>() ==
+                   &vec[common].getAny().template getRef<PairType>())
+            common++;
+        while (actions.size() > common) {
+            actions.pop_back();
+            states.pop_back();
+        }
+    }
+
+    Function<ObjectType(const ObjectType&)> cloneObject;
+    Function<ModelType(const ModelType&)> cloneModel;
+    vector<ShrinkableBase> actions;              ///< actions replayed, in order
+    vector<pair<ObjectType, ModelType>> states;  ///< states[k]: state after actions[0, k)
+};
+
 /**
  * Wrap a Shrinkable<vector<ShrinkableBase>> (elements: Shrinkable<pair<Random,Action>>)
  * with four shrink phases, then extract the final Shrinkable<list<Action>>:
@@ -84,6 +125,11 @@ Shrinkable<vector<ShrinkableBase>> genActionShrinkables(
  *                          when ObjectType is not copy-constructible (e.g. shared_ptr<T>
  *                          workaround where copies alias the same underlying object).
  * @param actionGenFactory  State-dependent action generator factory.
+ * @param cloneObject   If set, PrefixParams keeps the state after each action of a replayed prefix as a
+ *                      PrefixCheckpoints, snapshotted with this function, instead of replaying every prefix from
+ *                      initialFactory(). Without it, a node of n actions costs O(n²) action executions.
+ * @param cloneModel    Snapshots ModelType for the checkpoints. If not set, models are copied, which only keeps
+ *                      checkpoints intact for a ModelType with value semantics.
  */
 template <typename ObjectType, typename ModelType>
 Shrinkable<list<Action<ObjectType, ModelType>>> applyStatefulShrinkTree(
@@ -91,7 +137,9 @@ Shrinkable<list<Action<ObjectType, ModelType>>> applyStatefulShrinkTree(
     size_t minSize,
     const Function<ObjectType()>& initialFactory,
     const Function<ModelType(const ObjectType&)>& modelFactory,
-    const ActionGenFactory<ObjectType, ModelType>& actionGenFactory)
+    const ActionGenFactory<ObjectType, ModelType>& actionGenFactory,
+    const Function<ObjectType(const ObjectType&)>& cloneObject = {},
+    const Function<ModelType(const ModelType&)>& cloneModel = {})
 {
     using ActionType = Action<ObjectType, ModelType>;
     using PairType = pair<Random, ActionType>;
@@ -107,13 +155,71 @@ Shrinkable<list<Action<ObjectType, ModelType>>> applyStatefulShrinkTree(
     // the action from its stored bookmark, yields shrinks of that fresh tree.
     // Each replay calls initialFactory() for a fresh initial state — this is the
     // key fix for non-copyable ObjectType: no aliasing across replays.
+    // With cloneObject, the prefix states are instead kept in checkpoints and each
+    // position starts from a clone of its checkpoint.
+    auto regenerateAt = [minSize, actionGenFactory](const vector<ShrinkableBase>& vec, size_t i, ObjectType& simObj,
+                                                    ModelType& simModel) -> Stream {
+        const PairType& pairI = vec[i].getAny().getRef<PairType>();
+        Random bookmark = pairI.first;
+        Random randForGen = pairI.first;
+        auto freshActionShr = actionGenFactory(simObj, simModel)(randForGen);
+
+        return freshActionShr.getShrinks()
+            .template transform<ShrinkableBase, ShrinkableBase>(
+                [vec, i, minSize, bookmark](const ShrinkableBase& shrunkAction) -> ShrinkableBase {
+                    Shrinkable<ActionType> shrunkActionShr(shrunkAction);
+                    auto newPairShr = shrunkActionShr.template map<PairType>(
+                        [bookmark](const ActionType& action) -> PairType {
+                            return PairType(bookmark, action);
+                        });
+                    auto newVec = vec;
+                    newVec[i] = ShrinkableBase(newPairShr);
+                    auto newVecShr = make_shrinkable<vector<ShrinkableBase>>(newVec);
+                    auto newLengthShr = shrinkVectorLength(newVecShr, minSize);
+                    return ShrinkableBase(shrinkAnyVector(newLengthShr, minSize, true, false));
+                });
+    };
+
+    shared_ptr<PrefixCheckpoints<ObjectType, ModelType>> checkpoints;
+    if (cloneObject)
+        checkpoints = util::make_shared<PrefixCheckpoints<ObjectType, ModelType>>(cloneObject, cloneModel);
+
     auto withPhase2b = withPhase2.concat(
-        [initialFactory, modelFactory, actionGenFactory, minSize](ShrinkableBase& nodeShr) -> ShrinkableBase::StreamType {
+        [initialFactory, modelFactory, regenerateAt, checkpoints](ShrinkableBase& nodeShr) -> ShrinkableBase::StreamType {
             const auto& vec = nodeShr.getRef<vector<ShrinkableBase>>();
             if (vec.size() <= 1)
                 return ShrinkableBase::StreamType::empty();
 
             Stream result = Stream::empty();
+            if (checkpoints) {
+                auto& cp = *checkpoints;
+                cp.truncateTo(vec);
+                if (cp.states.empty()) {
+                    ObjectType initialObj = initialFactory();
+                    ModelType initialModel = modelFactory(initialObj);
+                    cp.states.emplace_back(util::move(initialObj), util::move(initialModel));
+                }
+                // states are needed before each non-last position
+                while (cp.actions.size() + 2 < vec.size()) {
+                    const size_t j = cp.actions.size();
+                    ObjectType simObj = cp.cloneObject(cp.states[j].first);
+                    ModelType simModel = cp.snapshotModel(cp.states[j].second);
+                    try {
+                        vec[j].getAny().getRef<PairType>().second(simObj, simModel);
+                    } catch (...) {
+                        break;
+                    }
+                    cp.actions.push_back(vec[j]);
+                    cp.states.emplace_back(util::move(simObj), util::move(simModel));
+                }
+                for (size_t i = 0; i + 1 < vec.size() && i < cp.states.size(); i++) {
+                    ObjectType simObj = cp.cloneObject(cp.states[i].first);
+                    ModelType simModel = cp.snapshotModel(cp.states[i].second);
+                    result = result.concat(regenerateAt(vec, i, simObj, simModel));
+                }
+                return result;
+            }
+
             for (size_t i = 0; i + 1 < vec.size(); i++) {
                 ObjectType simObj = initialFactory();  // fresh instance per slot replay
                 ModelType simModel = modelFactory(simObj);
@@ -128,27 +234,7 @@ Shrinkable<list<Action<ObjectType, ModelType>>> applyStatefulShrinkTree(
                 if (replayFailed)
                     break;
 
-                const PairType& pairI = vec[i].getAny().getRef<PairType>();
-                Random bookmark = pairI.first;
-                Random randForGen = pairI.first;
-                auto freshActionShr = actionGenFactory(simObj, simModel)(randForGen);
-
-                auto candidates = freshActionShr.getShrinks()
-                    .template transform<ShrinkableBase, ShrinkableBase>(
-                        [vec, i, minSize, bookmark](const ShrinkableBase& shrunkAction) -> ShrinkableBase {
-                            Shrinkable<ActionType> shrunkActionShr(shrunkAction);
-                            auto newPairShr = shrunkActionShr.template map<PairType>(
-                                [bookmark](const ActionType& action) -> PairType {
-                                    return PairType(bookmark, action);
-                                });
-                            auto newVec = vec;
-                            newVec[i] = ShrinkableBase(newPairShr);
-                            auto newVecShr = make_shrinkable<vector<ShrinkableBase>>(newVec);
-                            auto newLengthShr = shrinkVectorLength(newVecShr, minSize);
-                            return ShrinkableBase(shrinkAnyVector(newLengthShr, minSize, true, false));
-                        });
-
-                result = result.concat(candidates);
+                result = result.concat(regenerateAt(vec, i, simObj, simModel));
             }
             return result;
         });
@@ -195,12 +281,14 @@ Shrinkable<list<Action<ObjectType, ModelType>>> applyStatefulShrinkTree(
     size_t minSize,
     const ObjectType& initial,
     const Function<ModelType(const ObjectType&)>& modelFactory,
-    const ActionGenFactory<ObjectType, ModelType>& actionGenFactory)
+    const ActionGenFactory<ObjectType, ModelType>& actionGenFactory,
+    const Function<ObjectType(const ObjectType&)>& cloneObject = {},
+    const Function<ModelType(const ModelType&)>& cloneModel = {})
 {
     return applyStatefulShrinkTree<ObjectType, ModelType>(
         actionShrinkables, minSize,
         [initial]() -> ObjectType { return initial; },
-        modelFactory, actionGenFactory);
+        modelFactory, actionGenFactory, cloneObject, cloneModel);
 }
 
 } // namespace stateful
@@ -3,6 +3,7 @@
 #include "proptest/util/function_traits.hpp"
 #include "proptest/stateful/action_gen.hpp"
 #include "proptest/stateful/shrink_pipeline.hpp"
+#include "proptest/stateful/linearizability.hpp"
 #include "proptest/Generator.hpp"
 #include "proptest/combinator/transform.hpp"
 #include "proptest/combinator/oneof.hpp"
@@ -18,8 +19,13 @@
 #include "proptest/util/assert.hpp"
 #include "proptest/std/chrono.hpp"
 #include "proptest/std/optional.hpp"
+#include "proptest/std/set.hpp"
+#include "proptest/std/functional.hpp"
 #include "proptest/shrinker/listlike.hpp"
 #include "proptest/std/concepts.hpp"
+#include "proptest/util/thread_pool.hpp"
+#include "proptest/util/start_gate.hpp"
+#include "proptest/util/time_budget.hpp"
 #include <atomic>
 #include "proptest/std/exception.hpp"
 #include <mutex>
@@ -44,14 +50,15 @@ using std::mutex;
 using std::current_exception;
 using std::thread;
 
+/// interleaving of the actions of a concurrent run; action names are formatted only when printed
 struct PROPTEST_API ConcurrentTestDump {
     ConcurrentTestDump() {}
-    ConcurrentTestDump(const vector<string>& _front) : front(_front) {}
+    ConcurrentTestDump(const vector<ActionName>& _front) : front(_front) {}
 
     static constexpr int UNINITIALIZED_THREAD_ID = -2;
     static constexpr int FRONT_THREAD_ID = -1;
 
-    void setFront(const vector<string>& _front) {
+    void setFront(const vector<ActionName>& _front) {
         front = _front;
     }
 
@@ -61,7 +68,7 @@ struct PROPTEST_API ConcurrentTestDump {
         counter++;
     }
 
-    void initRear(const vector<string>& rear) {
+    void initRear(const vector<ActionName>& rear) {
         lock_guard<mutex> guard(mtx);
         rears.emplace_back(rear);
         for (size_t j = 0; j < rear.size() * 2; j++)
@@ -121,8 +128,8 @@ struct PROPTEST_API ConcurrentTestDump {
 
     atomic<int> counter{0};
     vector<int> log;
-    vector<string> front;
-    vector<vector<string>> rears;
+    vector<ActionName> front;
+    vector<vector<ActionName>> rears;
     mutable mutex mtx;
 };
 
@@ -146,6 +153,9 @@ inline ostream& show(ostream& os, const StatefulArgs<ObjectType, ModelType>& arg
     return os;
 }
 
+template <typename ObjectType, typename ModelType>
+struct StatefulRearRunner;
+
 template <typename ObjectType, typename ModelType>
 class StatefulProperty {
     using InitialGen = GenFunction<ObjectType>;
@@ -156,6 +166,7 @@ class StatefulProperty {
 
 public:
     static constexpr uint32_t defaultNumRuns = 1000;
+    static constexpr uint32_t defaultMaxDiscardRatio = 10;
     static constexpr size_t defaultActionListMinSize = 0;
     static constexpr size_t defaultActionListMaxSize = 20;
 
@@ -176,6 +187,13 @@ public:
         return *this;
     }
 
+    /// Engine for generating initial objects and actions; a seed reproduces its values only with the same engine
+    StatefulProperty& setRandomEngine(RandomEngine engine)
+    {
+        randomEngine = engine;
+        return *this;
+    }
+
     StatefulProperty& setNumRuns(uint32_t runs)
     {
         numRuns = runs;
@@ -188,12 +206,68 @@ public:
         return *this;
     }
 
+    /**
+     * @brief How rear threads wait for each other before a concurrent run starts (default: spin briefly, then
+     * block). StartGateMode::Spin releases them closest together but keeps a core busy per waiting thread
+     */
+    StatefulProperty& setStartGateMode(util::StartGateMode mode)
+    {
+        startGateMode = mode;
+        return *this;
+    }
+
+    /**
+     * @brief Whether to check that the calls of the rear threads are linearizable (default: false)
+     *
+     * The calls of the front and the rears whose actions called Context::linearize() are checked against the model
+     * as modelFactory made it, so every action that changes the system should describe its call.
+     */
+    StatefulProperty& setLinearizabilityCheck(bool check)
+    {
+        linearizabilityCheck = check;
+        return *this;
+    }
+
+    /**
+     * @brief Search states the linearizability check explores per run before giving up (default:
+     * LinearizabilityChecker::defaultMaxStates); a run whose check gives up is not failed
+     */
+    StatefulProperty& setLinearizabilityMaxStates(uint64_t maxStates)
+    {
+        linearizabilityMaxStates = maxStates;
+        return *this;
+    }
+
+    /**
+     * @brief Sizes the number of runs by a time budget, as Property::setTimeBudgetMs() does
+     *
+     * Without this, a stateful property takes its share of util::TimeBudget::global() when that is active. Either
+     * way, its time is charged to the global budget.
+     */
+    StatefulProperty& setTimeBudgetMs(uint32_t budgetMs)
+    {
+        timeBudgetMs = budgetMs;
+        return *this;
+    }
+
     StatefulProperty& setMaxDurationMs(uint32_t durationMs)
     {
         maxDurationMs = durationMs;
         return *this;
     }
 
+    /**
+     * @brief Sets how many discarded runs per run are allowed, as Property::setMaxDiscardRatio() does
+     *
+     * A run is discarded by PROP_DISCARD or by a filtered action generator that found no accepted action. When more
+     * than ratio * numRuns runs are discarded, go() stops and fails with "Gave up". 0 means no limit.
+     */
+    StatefulProperty& setMaxDiscardRatio(uint32_t ratio)
+    {
+        maxDiscardRatio = ratio;
+        return *this;
+    }
+
     StatefulProperty& setShrinkMaxRetries(uint32_t retries)
     {
         shrinkMaxRetries = retries;
@@ -212,6 +286,59 @@ public:
         return *this;
     }
 
+    /**
+     * @brief Skips shrink candidates that already passed, identified by the given hash of their action lists (the
+     * actions, or the front followed by the rears)
+     *
+     * The initial object does not shrink, so it is the same for all candidates and is not hashed. Candidates with
+     * equal hashes are considered the same, so the hash must not collide for candidates that behave differently:
+     * it should cover every parameter of the actions, not only their names. There is no cache without a hash, as
+     * the printed form of an action does not tell apart actions whose names leave out a parameter.
+     */
+    StatefulProperty& setShrinkCacheHash(Function<size_t(const vector<ActionList>&)> hashFunc)
+    {
+        shrinkCacheHash = hashFunc;
+        return *this;
+    }
+
+    /**
+     * @brief Keeps the states reached while replaying action prefixes during shrinking, instead of replaying each
+     * prefix from the initial state (O(n) rather than O(n²) action executions per shrink step). States are
+     * snapshotted by copying ObjectType and ModelType, so both must be value types: a copy that shares state with
+     * the original (e.g. a shared_ptr) lets replays change the stored checkpoints. Use setStateClone() for those.
+     */
+    template <typename O = ObjectType>
+        requires copy_constructible<O>
+    StatefulProperty& setPrefixCheckpoints(bool enable)
+    {
+        if (enable)
+            stateClone = [](const ObjectType& obj) -> ObjectType { return obj; };
+        else
+            stateClone = {};
+        modelClone = {};
+        return *this;
+    }
+
+    /**
+     * @brief Same as setPrefixCheckpoints(true), snapshotting ObjectType with clone (e.g. a deep copy behind a
+     * shared_ptr); ModelType is copied and must be a value type
+     */
+    StatefulProperty& setStateClone(Function<ObjectType(const ObjectType&)> clone)
+    {
+        stateClone = util::move(clone);
+        modelClone = {};
+        return *this;
+    }
+
+    /// Same as setPrefixCheckpoints(true), snapshotting ObjectType with objClone and ModelType with modelClone
+    StatefulProperty& setStateClone(Function<ObjectType(const ObjectType&)> objClone,
+                                    Function<ModelType(const ModelType&)> _modelClone)
+    {
+        stateClone = util::move(objClone);
+        modelClone = util::move(_modelClone);
+        return *this;
+    }
+
     StatefulProperty& setOnReproductionStats(Function<void(ReproductionStats)> f)
     {
         onReproductionStats = util::move(f);
@@ -321,18 +448,27 @@ public:
 
 private:
     optional<uint64_t> seed = nullopt;
+    optional<RandomEngine> randomEngine = nullopt;
     optional<uint32_t> numRuns = nullopt;
+    optional<uint32_t> maxDiscardRatio = nullopt;
     optional<uint32_t> maxDurationMs = nullopt;
+    optional<uint32_t> timeBudgetMs = nullopt;
     optional<uint32_t> shrinkMaxRetries = nullopt;
     optional<uint32_t> shrinkTimeoutMs = nullopt;
     optional<uint32_t> shrinkRetryTimeoutMs = nullopt;
     uint32_t maxConcurrency = 0;
+    optional<util::StartGateMode> startGateMode = nullopt;
+    optional<bool> linearizabilityCheck = nullopt;
+    optional<uint64_t> linearizabilityMaxStates = nullopt;
     InitialGen initialGen;
     ModelFactoryFunction modelFactory;
     ActionGenFactory<ObjectType, ModelType> actionGenFactory;
     size_t actionListMinSize = defaultActionListMinSize;
     size_t actionListMaxSize = defaultActionListMaxSize;
 
+    Function<ObjectType(const ObjectType&)> stateClone;
+    Function<ModelType(const ModelType&)> modelClone;
+    Function<size_t(const vector<ActionList>&)> shrinkCacheHash;
     Function<void(ObjectType&, ModelType&)> postCheck;
     Function<void(ObjectType&, ModelType&)> onActionStart;
     Function<void(ObjectType&, ModelType&)> onActionEnd;
@@ -345,11 +481,22 @@ private:
     ostream* errorStream = &cerr;
 
     optional<ReproductionStats> lastReproductionStats;
+    /// threads running the rears of concurrent runs, kept across runs and shrink candidates (shared by copies)
+    mutable shared_ptr<util::ThreadPool> rearPool;
 
     bool invoke(Random& rand);
+    void runRears(vector<StatefulRearRunner<ObjectType, ModelType>>& rearRunners) const;
     void handleShrink(Random& savedRand);
     void writeArgs(ostream& os, const vector<ShrinkableBase>& args) const;
+    string shrinkCacheKey(const vector<ShrinkableBase>& args) const;
     pair<bool, string> runCandidate(const vector<ShrinkableBase>& args) const;
+
+    void checkLinearizability(const LinearizabilityHistory<ModelType>& history) const
+    {
+        assertLinearizable(history,
+                           linearizabilityMaxStates.value_or(LinearizabilityChecker<ModelType>::defaultMaxStates));
+    }
+
     void assessFailureForRetry(vector<ShrinkableBase>& args, int64_t& candidateTimeoutMs, int assessmentIndex);
 
     Generator<ArgsType> makeStaticArgsGen() const
@@ -376,10 +523,11 @@ private:
     {
         return Generator<ObjectType>(initialGen).template flatMap<ArgsType>(
             [modelFactory = this->modelFactory, actionGenFactory = this->actionGenFactory,
-             actionListMinSize = this->actionListMinSize, actionListMaxSize = this->actionListMaxSize](
-                ObjectType& initial) -> Generator<ArgsType> {
+             actionListMinSize = this->actionListMinSize, actionListMaxSize = this->actionListMaxSize,
+             stateClone = this->stateClone, modelClone = this->modelClone](ObjectType& initial) -> Generator<ArgsType> {
                 return Generator<ArgsType>(Function<Shrinkable<ArgsType>(Random&)>(
-                    [initial, modelFactory, actionGenFactory, actionListMinSize, actionListMaxSize](
+                    [initial, modelFactory, actionGenFactory, actionListMinSize, actionListMaxSize, stateClone,
+                     modelClone](
                         Random& rand) mutable -> Shrinkable<ArgsType> {
                         ObjectType obj = initial;
                         auto model = modelFactory(obj);
@@ -388,7 +536,7 @@ private:
                             genActionShrinkables(rand, obj, model, actionGenFactory, numActions);
                         auto actionListShr = applyStatefulShrinkTree(
                             actionShrinkables, actionListMinSize,
-                            initial, modelFactory, actionGenFactory);
+                            initial, modelFactory, actionGenFactory, stateClone, modelClone);
                         return actionListShr.template map<ArgsType>(
                             [initial](list<Action<ObjectType, ModelType>>& actions) {
                                 return ArgsType(actions, initial);
@@ -405,7 +553,8 @@ struct StatefulRearRunner
     using ActionList = list<ActionType>;
 
     StatefulRearRunner(int _num, ObjectType& _obj, ModelType& _model, const ActionList& _actions,
-                       atomic_bool& _thread_ready, atomic_bool& _sync_ready, ConcurrentTestDump& _dump,
+                       util::StartGate& _startGate, ConcurrentTestDump& _dump,
+                       LinearizabilityHistory<ModelType>* _history,
                        Function<void(ObjectType&, ModelType&)> _onActionStart,
                        Function<void(ObjectType&, ModelType&)> _onActionEnd,
                        shared_ptr<exception_ptr> _firstException,
@@ -414,9 +563,9 @@ struct StatefulRearRunner
           obj(_obj),
           model(_model),
           actions(_actions),
-          thread_ready(_thread_ready),
-          sync_ready(_sync_ready),
+          startGate(_startGate),
           dump(_dump),
+          history(_history),
           onActionStart(_onActionStart),
           onActionEnd(_onActionEnd),
           firstException(_firstException),
@@ -426,8 +575,7 @@ struct StatefulRearRunner
 
     void operator()()
     {
-        thread_ready = true;
-        while (!sync_ready) {}
+        startGate.arriveAndWait();
 
         try {
             Context context{num};
@@ -435,7 +583,10 @@ struct StatefulRearRunner
                 dump.markActionStart(num);
                 if (onActionStart)
                     onActionStart(obj, model);
+                const uint64_t invokedAt = history ? history->tick() : 0;
                 action(obj, model, context);
+                if (history)
+                    history->record(context, invokedAt, action.name);
                 if (onActionEnd)
                     onActionEnd(obj, model);
                 dump.markActionEnd(num);
@@ -451,9 +602,10 @@ struct StatefulRearRunner
     ObjectType& obj;
     ModelType& model;
     const ActionList& actions;
-    atomic_bool& thread_ready;
-    atomic_bool& sync_ready;
+    util::StartGate& startGate;
     ConcurrentTestDump& dump;
+    /// calls to check for linearizability, or nullptr
+    LinearizabilityHistory<ModelType>* history;
     Function<void(ObjectType&, ModelType&)> onActionStart;
     Function<void(ObjectType&, ModelType&)> onActionEnd;
     shared_ptr<exception_ptr> firstException;
@@ -464,17 +616,45 @@ template <typename ObjectType, typename ModelType>
 bool StatefulProperty<ObjectType, ModelType>::go()
 {
     const uint64_t effectiveSeed = seed.value_or(util::getGlobalSeed());
+    const RandomEngine effectiveEngine = randomEngine.value_or(util::getGlobalRandomEngine());
     const uint32_t effectiveNumRuns = numRuns.value_or(defaultNumRuns);
     const uint32_t effectiveMaxDurationMs = maxDurationMs.value_or(0);
-
-    Random rand(effectiveSeed);
-    Random savedRand(effectiveSeed);
-    *outputStream << "random seed: " << effectiveSeed << endl;
+    const uint64_t maxDiscards = static_cast<uint64_t>(maxDiscardRatio.value_or(defaultMaxDiscardRatio)) * effectiveNumRuns;
+    uint64_t numDiscarded = 0;
+    util::TimeBudgetCharge budgetCharge;
+    const uint64_t effectiveTimeBudgetMs =
+        timeBudgetMs.has_value() ? timeBudgetMs.value() : util::TimeBudget::global().nextShareMs();
+
+    Random rand(effectiveSeed, effectiveEngine);
+    Random savedRand(effectiveSeed, effectiveEngine);
+    *outputStream << "random seed: " << effectiveSeed;
+    if (effectiveEngine != RandomEngine::MT19937_64)
+        *outputStream << " (" << util::randomEngineName(effectiveEngine) << ")";
+    *outputStream << endl;
     auto startedTime = steady_clock::now();
 
+    // with a time budget, the number of runs is planned from the cost of the first ones
+    uint32_t plannedNumRuns = effectiveNumRuns;
+
     uint32_t i = 0;
     try {
-        for (; i < effectiveNumRuns; i++) {
+        for (; i < plannedNumRuns; i++) {
+            if (effectiveTimeBudgetMs != 0) {
+                const double elapsedMs =
+                    std::chrono::duration<double, std::milli>(steady_clock::now() - startedTime).count();
+                if (i == util::kBudgetCalibrationRuns) {
+                    plannedNumRuns = util::planNumRuns(effectiveNumRuns, i, elapsedMs, effectiveTimeBudgetMs);
+                    *outputStream << "Planned " << plannedNumRuns << " runs for a time budget of "
+                                  << effectiveTimeBudgetMs << "ms" << endl;
+                }
+                if (elapsedMs >= static_cast<double>(effectiveTimeBudgetMs)) {
+                    *outputStream << "Time budget of " << effectiveTimeBudgetMs << "ms used up, passed " << i
+                                  << " tests" << endl;
+                    return true;
+                }
+                if (i >= plannedNumRuns)
+                    break;
+            }
             if (effectiveMaxDurationMs != 0) {
                 auto currentTime = steady_clock::now();
                 auto elapsed = duration_cast<util::milliseconds>(currentTime - startedTime).count();
@@ -497,6 +677,11 @@ bool StatefulProperty<ObjectType, ModelType>::go()
                     pass = true;
                 } catch (const Discard&) {
                     pass = false;
+                    if (++numDiscarded > maxDiscards && maxDiscards != 0) {
+                        *errorStream << "Gave up after " << i << " tests: " << numDiscarded << " runs discarded"
+                                     << endl;
+                        return false;
+                    }
                 }
             } while (!pass);
         }
@@ -514,7 +699,7 @@ bool StatefulProperty<ObjectType, ModelType>::go()
         return false;
     }
 
-    *outputStream << "OK, passed " << effectiveNumRuns << " tests" << endl;
+    *outputStream << "OK, passed " << i << " tests" << endl;
     return true;
 }
 
@@ -524,13 +709,16 @@ bool StatefulProperty<ObjectType, ModelType>::invoke(Random& rand)
     Shrinkable<ObjectType> initialShr = initialGen(rand);
     ObjectType& obj = initialShr.getMutableRef();
     ModelType model = modelFactory(obj);
+    optional<LinearizabilityHistory<ModelType>> history;
+    if (linearizabilityCheck.value_or(false))
+        history.emplace(maxConcurrency, model);
 
     ConcurrentTestDump dump;
     vector<ActionList> rearLists;
     rearLists.reserve(maxConcurrency);
 
     const size_t frontSize = rand.getRandomSize(actionListMinSize, actionListMaxSize + 1);
-    vector<string> frontNames;
+    vector<ActionName> frontNames;
     frontNames.reserve(frontSize);
     Context frontCtx{ConcurrentTestDump::FRONT_THREAD_ID};
     for (size_t i = 0; i < frontSize; i++) {
@@ -540,7 +728,10 @@ bool StatefulProperty<ObjectType, ModelType>::invoke(Random& rand)
         frontNames.push_back(action.name);
         if (onActionStart)
             onActionStart(obj, model);
+        const uint64_t invokedAt = history ? history->tick() : 0;
         action(obj, model, frontCtx);
+        if (history)
+            history->record(frontCtx, invokedAt, action.name);
         if (onActionEnd)
             onActionEnd(obj, model);
         dump.appendFront();
@@ -569,46 +760,52 @@ bool StatefulProperty<ObjectType, ModelType>::invoke(Random& rand)
     }
 
     if (maxConcurrency <= 1) {
+        if (history)
+            checkLinearizability(*history);
         if (postCheck)
             postCheck(obj, model);
         return true;
     }
 
-    atomic_bool sync_ready(false);
-    vector<shared_ptr<atomic_bool>> thread_ready;
-    vector<thread> rearRunners;
+    util::StartGate startGate(maxConcurrency, startGateMode.value_or(util::StartGateMode::SpinThenBlock));
+    vector<StatefulRearRunner<ObjectType, ModelType>> rearRunners;
     auto firstException = util::make_shared<exception_ptr>();
     auto exceptionMutex = util::make_shared<mutex>();
-    thread_ready.reserve(maxConcurrency);
     rearRunners.reserve(maxConcurrency);
 
     for (uint32_t i = 0; i < maxConcurrency; i++) {
-        thread_ready.emplace_back(new atomic_bool(false));
-        vector<string> rearNames;
+        vector<ActionName> rearNames;
         util::transform(rearLists[i].begin(), rearLists[i].end(), util::back_inserter(rearNames),
                         [](const ActionType& action) { return action.name; });
         dump.initRear(rearNames);
     }
 
     for (uint32_t i = 0; i < maxConcurrency; i++) {
-        rearRunners.emplace_back(StatefulRearRunner<ObjectType, ModelType>(
-            static_cast<int>(i), obj, model, rearLists[i], *thread_ready[i], sync_ready, dump,
-            onActionStart, onActionEnd, firstException, exceptionMutex));
+        rearRunners.emplace_back(static_cast<int>(i), obj, model, rearLists[i], startGate, dump,
+                                 history ? &*history : nullptr, onActionStart, onActionEnd, firstException,
+                                 exceptionMutex);
     }
 
-    for (uint32_t i = 0; i < maxConcurrency; i++)
-        while (!*thread_ready[i]) {}
-    sync_ready = true;
-    for (uint32_t i = 0; i < maxConcurrency; i++)
-        rearRunners[i].join();
+    runRears(rearRunners);
     if (*firstException)
         std::rethrow_exception(*firstException);
+    if (history)
+        checkLinearizability(*history);
 
     if (postCheck)
         postCheck(obj, model);
     return true;
 }
 
+template <typename ObjectType, typename ModelType>
+void StatefulProperty<ObjectType, ModelType>::runRears(vector<StatefulRearRunner<ObjectType, ModelType>>& rearRunners) const
+{
+    // a worker stays in its rear until every rear has started, so each rear gets a thread of its own
+    if (!rearPool || rearPool->size() < rearRunners.size())
+        rearPool = util::make_shared<util::ThreadPool>(rearRunners.size());
+    rearPool->parallelFor(rearRunners.size(), [&rearRunners](size_t i) { rearRunners[i](); });
+}
+
 template <typename ObjectType, typename ModelType>
 void StatefulProperty<ObjectType, ModelType>::writeArgs(ostream& os, const vector<ShrinkableBase>& args) const
 {
@@ -627,6 +824,21 @@ void StatefulProperty<ObjectType, ModelType>::writeArgs(ostream& os, const vecto
     os << " }";
 }
 
+template <typename ObjectType, typename ModelType>
+string StatefulProperty<ObjectType, ModelType>::shrinkCacheKey(const vector<ShrinkableBase>& args) const
+{
+    // args[0] is the initial-state factory, shared by all candidates of a shrink; its address stands for the initial
+    // object, so that it is not constructed just for the key
+    const void* initialIdentity = &args[0].getAny().template getRef<Function<ObjectType()>>();
+    vector<ActionList> actionLists;
+    actionLists.reserve(args.size() - 1);
+    for (size_t i = 1; i < args.size(); i++)
+        actionLists.push_back(args[i].getAny().template getRef<ActionList>());
+    stringstream str;
+    str << initialIdentity << ":" << shrinkCacheHash(actionLists);
+    return str.str();
+}
+
 template <typename ObjectType, typename ModelType>
 pair<bool, string> StatefulProperty<ObjectType, ModelType>::runCandidate(const vector<ShrinkableBase>& args) const
 {
@@ -640,51 +852,53 @@ pair<bool, string> StatefulProperty<ObjectType, ModelType>::runCandidate(const v
         ObjectType obj = initialFactory();
         ModelType model = modelFactory(obj);
         const auto& front = args[1].getAny().template getRef<ActionList>();
+        const int effectiveThreads = static_cast<int>(args.size()) - 2;
+        optional<LinearizabilityHistory<ModelType>> history;
+        if (linearizabilityCheck.value_or(false))
+            history.emplace(static_cast<size_t>(util::max(effectiveThreads, 0)), model);
 
         Context frontCtx{ConcurrentTestDump::FRONT_THREAD_ID};
         for (auto action : front) {
             if (onActionStart)
                 onActionStart(obj, model);
+            const uint64_t invokedAt = history ? history->tick() : 0;
             action(obj, model, frontCtx);
+            if (history)
+                history->record(frontCtx, invokedAt, action.name);
             if (onActionEnd)
                 onActionEnd(obj, model);
         }
 
-        const int effectiveThreads = static_cast<int>(args.size()) - 2;
         if (effectiveThreads > 0) {
-            atomic_bool sync_ready(false);
-            vector<shared_ptr<atomic_bool>> thread_ready;
-            vector<thread> rearRunners;
+            util::StartGate startGate(static_cast<uint32_t>(effectiveThreads),
+                                      startGateMode.value_or(util::StartGateMode::SpinThenBlock));
+            vector<StatefulRearRunner<ObjectType, ModelType>> rearRunners;
             vector<ActionList> rearCopies;
             ConcurrentTestDump dump;
             auto firstException = util::make_shared<exception_ptr>();
             auto exceptionMutex = util::make_shared<mutex>();
-            thread_ready.reserve(effectiveThreads);
             rearRunners.reserve(effectiveThreads);
             rearCopies.reserve(effectiveThreads);
 
             for (int i = 0; i < effectiveThreads; i++) {
-                thread_ready.emplace_back(new atomic_bool(false));
                 rearCopies.push_back(args[2 + i].getAny().template getRef<ActionList>());
-                vector<string> rearNames;
+                vector<ActionName> rearNames;
                 util::transform(rearCopies.back().begin(), rearCopies.back().end(),
                                 util::back_inserter(rearNames),
                                 [](const ActionType& action) { return action.name; });
                 dump.initRear(rearNames);
             }
             for (int i = 0; i < effectiveThreads; i++) {
-                rearRunners.emplace_back(StatefulRearRunner<ObjectType, ModelType>(
-                    i, obj, model, rearCopies[i], *thread_ready[i], sync_ready, dump,
-                    onActionStart, onActionEnd, firstException, exceptionMutex));
+                rearRunners.emplace_back(i, obj, model, rearCopies[i], startGate, dump,
+                                         history ? &*history : nullptr, onActionStart, onActionEnd,
+                                         firstException, exceptionMutex);
             }
-            for (int i = 0; i < effectiveThreads; i++)
-                while (!*thread_ready[i]) {}
-            sync_ready = true;
-            for (int i = 0; i < effectiveThreads; i++)
-                rearRunners[i].join();
+            runRears(rearRunners);
             if (*firstException)
                 std::rethrow_exception(*firstException);
         }
+        if (history)
+            checkLinearizability(*history);
 
         if (postCheck)
             postCheck(obj, model);
@@ -747,6 +961,9 @@ void StatefulProperty<ObjectType, ModelType>::assessFailureForRetry(
 template <typename ObjectType, typename ModelType>
 void StatefulProperty<ObjectType, ModelType>::handleShrink(Random& savedRand)
 {
+    // shrink tree nodes created below are short-lived; draw them from a session arena
+    util::ShrinkArenaScope arenaScope;
+
     auto isShrinkPhaseTimedOut = +[](steady_clock::time_point phaseStart, uint32_t timeoutMs) -> bool {
         if (timeoutMs == 0)
             return false;
@@ -780,7 +997,7 @@ void StatefulProperty<ObjectType, ModelType>::handleShrink(Random& savedRand)
 
     auto wrappedFront = applyStatefulShrinkTree(
         frontActionShrinkables, actionListMinSize,
-        initialFactory, modelFactory, actionGenFactory);
+        initialFactory, modelFactory, actionGenFactory, stateClone, modelClone);
 
     struct RearShrinkables {
         Shrinkable<ActionList> wrapped;
@@ -798,11 +1015,13 @@ void StatefulProperty<ObjectType, ModelType>::handleShrink(Random& savedRand)
         ObjectType postFrontObjCapture = frontObj;
         ModelType postFrontModelCapture = frontModel;
         Function<ModelType(const ObjectType&)> rearModelFactory =
-            [postFrontModelCapture](const ObjectType&) { return postFrontModelCapture; };
+            [postFrontModelCapture, modelClone = this->modelClone](const ObjectType&) {
+                return modelClone ? modelClone(postFrontModelCapture) : postFrontModelCapture;
+            };
 
         auto wrappedRear = applyStatefulShrinkTree(
             rearActionShrinkables, actionListMinSize,
-            postFrontObjCapture, rearModelFactory, actionGenFactory);
+            postFrontObjCapture, rearModelFactory, actionGenFactory, stateClone, modelClone);
 
         rearShrinkablesList.push_back({util::move(wrappedRear)});
     }
@@ -837,7 +1056,7 @@ void StatefulProperty<ObjectType, ModelType>::handleShrink(Random& savedRand)
     bool anyShrinkFound = false;
     int assessmentIndex = 0;
 
-    auto shrinkTestCandidate = [&](const vector<ShrinkableBase>& curArgs) -> pair<bool, string> {
+    auto runCandidateWithRetry = [&](const vector<ShrinkableBase>& curArgs) -> pair<bool, string> {
         if (!useRetry) {
             return runCandidate(curArgs);
         }
@@ -857,6 +1076,25 @@ void StatefulProperty<ObjectType, ModelType>::handleShrink(Random& savedRand)
         return {false, ""};
     };
 
+    // keys of candidates that passed; shrinking action lists yields the same list more than once
+    const bool useCache = static_cast<bool>(shrinkCacheHash);
+    unordered_set<string> passedCandidates;
+    size_t numCacheHits = 0;
+
+    auto shrinkTestCandidate = [&](const vector<ShrinkableBase>& curArgs) -> pair<bool, string> {
+        if (!useCache)
+            return runCandidateWithRetry(curArgs);
+        string key = shrinkCacheKey(curArgs);
+        if (passedCandidates.count(key)) {
+            numCacheHits++;
+            return {false, ""};
+        }
+        auto result = runCandidateWithRetry(curArgs);
+        if (!result.first)
+            passedCandidates.insert(util::move(key));
+        return result;
+    };
+
     auto notifyShrinkAccepted = [this](const vector<ShrinkableBase>& args, const string& failureMsg) {
         if (!onShrinkAccepted)
             return;
@@ -939,6 +1177,8 @@ void StatefulProperty<ObjectType, ModelType>::handleShrink(Random& savedRand)
         }
     }
 
+    if (numCacheHits > 0)
+        *outputStream << "  shrink cache skipped " << numCacheHits << " already passed candidate(s)" << endl;
     if (anyShrinkFound) {
         *outputStream << "  simplest args found by shrinking: ";
         writeArgs(*outputStream, shrVec);
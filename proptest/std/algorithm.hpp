@@ -7,5 +7,8 @@ namespace util {
 using std::transform;
 using std::back_inserter;
 using std::inserter;
+using std::sort;
+using std::min;
+using std::max;
 } // namespace util
 } // namespace proptest
@@ -6,5 +6,6 @@ namespace proptest {
 using std::invoke_result;
 using std::invoke_result_t;
 using std::function;
+using std::hash;
 
 } // namespace proptest
@@ -1,6 +1,8 @@
 #pragma once
 #include <map>
+#include <unordered_map>
 
 namespace proptest {
 using std::map;
+using std::unordered_map;
 } // namespace proptest
@@ -8,6 +8,8 @@ using std::static_pointer_cast;
 using std::unique_ptr;
 
 namespace util {
+using std::allocate_shared;
+using std::allocator;
 using std::make_shared;
 using std::make_unique;
 }  // namespace util
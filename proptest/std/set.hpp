@@ -1,6 +1,8 @@
 #pragma once
 #include <set>
+#include <unordered_set>
 
 namespace proptest {
 using std::set;
+using std::unordered_set;
 } // namespace proptest
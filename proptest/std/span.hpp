@@ -0,0 +1,6 @@
+#pragma once
+#include <span>
+
+namespace proptest {
+using std::span;
+} // namespace proptest
@@ -1,10 +1,12 @@
 #pragma once
 #include <string>
+#include <string_view>
 
 namespace proptest {
 
 using std::basic_string;
 using std::string;
+using std::string_view;
 using std::to_string;
 
 } // namespace proptest
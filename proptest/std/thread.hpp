@@ -0,0 +1,17 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace proptest {
+
+using std::atomic;
+using std::condition_variable;
+using std::lock_guard;
+using std::mutex;
+using std::scoped_lock;
+using std::thread;
+using std::unique_lock;
+
+} // namespace proptest
@@ -12,6 +12,7 @@ using std::get;
 
 namespace util {
 using std::make_tuple;
+using std::apply;
 }  // namespace util
 
 } // namespace proptest
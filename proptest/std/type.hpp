@@ -7,8 +7,10 @@ namespace proptest {
 using std::decay_t;
 using std::is_trivial;
 using std::remove_const_t;
+using std::remove_cv_t;
 using std::remove_reference;
 using std::remove_reference_t;
+using std::remove_extent_t;
 using std::type_info;
 using std::bad_cast;
 
@@ -24,6 +26,8 @@ using std::is_constructible_v;
 using std::is_convertible_v;
 using std::is_copy_constructible_v;
 using std::is_fundamental_v;
+using std::is_trivially_copyable_v;
+using std::is_array_v;
 using std::is_lvalue_reference;
 using std::is_lvalue_reference_v;
 using std::is_move_constructible_v;
@@ -38,6 +42,7 @@ using std::is_same_v;
 using std::is_base_of_v;
 using std::is_integral_v;
 using std::is_signed;
+using std::is_signed_v;
 using std::is_void_v;
 
 using std::enable_if;
@@ -4,4 +4,6 @@
 namespace proptest {
 using std::variant;
 using std::holds_alternative;
+using std::get_if;
+using std::visit;
 } // namespace proptest
@@ -0,0 +1,153 @@
+#include "proptest/test/bench/bench_util.hpp"
+#include "proptest/proptest.hpp"
+#include "proptest/util/arena.hpp"
+
+using namespace proptest;
+
+// checks the allocation counter itself: a value stored inline in Any allocates nothing, a vector in Any allocates its
+// holder and its buffer, and in a shrink session the holder comes from an arena chunk (an over-aligned new)
+static void BM_AllocationCountSanity(benchmark::State& state)
+{
+    const vector<int> vec(16, 1);
+    int64_t numItems = 0;
+    uint64_t inlineAllocs = 0, heapAllocs = 0, arenaAllocs = 0;
+    for (auto _ : state) {
+        uint64_t before = bench::allocationCount();
+        {
+            Any small(static_cast<int64_t>(numItems));
+            benchmark::DoNotOptimize(small);
+        }
+        inlineAllocs += bench::allocationCount() - before;
+
+        before = bench::allocationCount();
+        {
+            Any large(vec);
+            benchmark::DoNotOptimize(large);
+        }
+        heapAllocs += bench::allocationCount() - before;
+
+        before = bench::allocationCount();
+        {
+            util::ShrinkArenaScope scope;
+            Any large(vec);
+            benchmark::DoNotOptimize(large);
+        }
+        arenaAllocs += bench::allocationCount() - before;
+        numItems++;
+    }
+    const uint64_t expected = 2 * static_cast<uint64_t>(numItems);
+    if (inlineAllocs != 0 || heapAllocs != expected || arenaAllocs != expected)
+        state.SkipWithError("allocation counter missed allocations");
+    state.counters["inline_allocs"] = static_cast<double>(inlineAllocs) / static_cast<double>(numItems);
+    state.counters["heap_allocs"] = static_cast<double>(heapAllocs) / static_cast<double>(numItems);
+    state.counters["arena_allocs"] = static_cast<double>(arenaAllocs) / static_cast<double>(numItems);
+}
+
+BENCHMARK(BM_AllocationCountSanity);
+
+// generated values per second of Arbi<T> with default settings
+template <typename T>
+static void BM_Arbi(benchmark::State& state)
+{
+    Random rand(1);
+    auto arbi = Arbi<T>();
+    int64_t numItems = 0;
+    uint64_t allocsBefore = bench::allocationCount();
+    for (auto _ : state) {
+        auto shr = arbi(rand);
+        benchmark::DoNotOptimize(shr.getRef());
+        numItems++;
+    }
+    bench::reportItems(state, numItems, allocsBefore);
+}
+
+// aliases keep template commas out of the BENCHMARK macro
+using IntStringPair = pair<int, string>;
+using IntDoubleBoolTuple = tuple<int, double, bool>;
+
+BENCHMARK(BM_Arbi<bool>);
+BENCHMARK(BM_Arbi<int8_t>);
+BENCHMARK(BM_Arbi<int32_t>);
+BENCHMARK(BM_Arbi<int64_t>);
+BENCHMARK(BM_Arbi<uint64_t>);
+BENCHMARK(BM_Arbi<float>);
+BENCHMARK(BM_Arbi<double>);
+BENCHMARK(BM_Arbi<string>);
+BENCHMARK(BM_Arbi<UTF8String>);
+BENCHMARK(BM_Arbi<IntStringPair>);
+BENCHMARK(BM_Arbi<IntDoubleBoolTuple>);
+
+// containers of a fixed size given by the benchmark argument
+template <typename Container>
+static void BM_ArbiSized(benchmark::State& state)
+{
+    Random rand(1);
+    const size_t size = static_cast<size_t>(state.range(0));
+    auto arbi = Arbi<Container>(size, size);
+    int64_t numItems = 0;
+    uint64_t allocsBefore = bench::allocationCount();
+    for (auto _ : state) {
+        auto shr = arbi(rand);
+        benchmark::DoNotOptimize(shr.getRef());
+        numItems++;
+    }
+    bench::reportItems(state, numItems, allocsBefore);
+}
+
+BENCHMARK(BM_ArbiSized<string>)->Arg(8)->Arg(64)->Arg(512);
+BENCHMARK(BM_ArbiSized<UTF8String>)->Arg(8)->Arg(64)->Arg(512);
+BENCHMARK(BM_ArbiSized<UTF16BEString>)->Arg(8)->Arg(64);
+BENCHMARK(BM_ArbiSized<vector<int>>)->Arg(8)->Arg(64)->Arg(512);
+BENCHMARK(BM_ArbiSized<list<int>>)->Arg(8)->Arg(64)->Arg(512);
+BENCHMARK(BM_ArbiSized<vector<string>>)->Arg(8)->Arg(64);
+
+// Random is copied for every run and every stateful bookmark; the argument selects the RandomEngine
+static RandomEngine engineArg(const benchmark::State& state)
+{
+    return static_cast<RandomEngine>(state.range(0));
+}
+
+static void BM_RandomCopy(benchmark::State& state)
+{
+    Random rand(1, engineArg(state));
+    for (auto _ : state) {
+        Random copy(rand);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RandomCopy)->Arg(0)->Arg(1);
+
+static void BM_RandomUInt64(benchmark::State& state)
+{
+    Random rand(1, engineArg(state));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(rand.getRandomUInt64());
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RandomUInt64)->Arg(0)->Arg(1);
+
+static void BM_RandomInt32Bounded(benchmark::State& state)
+{
+    Random rand(1, engineArg(state));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(rand.getRandomInt32(-1000, 1000));
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RandomInt32Bounded)->Arg(0)->Arg(1);
+
+static void BM_RandomFillUInt64(benchmark::State& state)
+{
+    Random rand(1, engineArg(state));
+    uint64_t buffer[256];
+    for (auto _ : state) {
+        rand.fillUInt64(buffer);
+        benchmark::DoNotOptimize(buffer);
+    }
+    state.SetItemsProcessed(state.iterations() * 256);
+}
+
+BENCHMARK(BM_RandomFillUInt64)->Arg(0)->Arg(1);
@@ -0,0 +1,133 @@
+#include "proptest/test/bench/bench_util.hpp"
+#include "proptest/proptest.hpp"
+#include "proptest/stateful/stateful_function.hpp"
+
+using namespace proptest;
+using namespace proptest::stateful;
+
+// end-to-end forAll runs per second
+static void BM_ForAllInt(benchmark::State& state)
+{
+    const uint32_t numRuns = 100;
+    int64_t numItems = 0;
+    uint64_t allocsBefore = bench::allocationCount();
+    for (auto _ : state) {
+        bool result = forAll([](int a, int b) { return static_cast<int64_t>(a) - b <= UINT32_MAX; },
+                             {.seed = 1, .numRuns = numRuns, .outputStream = &bench::nullStream(),
+                              .errorStream = &bench::nullStream()});
+        benchmark::DoNotOptimize(result);
+        numItems += numRuns;
+    }
+    bench::reportItems(state, numItems, allocsBefore);
+}
+
+BENCHMARK(BM_ForAllInt);
+
+// the benchmark argument is the container size
+static void BM_ForAllVector(benchmark::State& state)
+{
+    const uint32_t numRuns = 100;
+    const size_t size = static_cast<size_t>(state.range(0));
+    int64_t numItems = 0;
+    uint64_t allocsBefore = bench::allocationCount();
+    for (auto _ : state) {
+        bool result = forAll([](vector<int> v) { return v.size() < 1000000; },
+                             {.seed = 1, .numRuns = numRuns, .outputStream = &bench::nullStream(),
+                              .errorStream = &bench::nullStream()},
+                             gen::vector<int>({.minSize = size, .maxSize = size}));
+        benchmark::DoNotOptimize(result);
+        numItems += numRuns;
+    }
+    bench::reportItems(state, numItems, allocsBefore);
+}
+
+BENCHMARK(BM_ForAllVector)->Arg(8)->Arg(64)->Arg(512);
+
+// a failing property: generation, then shrinking down to the simplest counterexample
+static void BM_ForAllShrink(benchmark::State& state)
+{
+    const size_t size = static_cast<size_t>(state.range(0));
+    int64_t numItems = 0;
+    uint64_t allocsBefore = bench::allocationCount();
+    for (auto _ : state) {
+        bool result = forAll([](vector<int> v) {
+                                 PROP_ASSERT(v.size() < 4 || v[0] < 1000);
+                                 return true;
+                             },
+                             {.seed = 1, .outputStream = &bench::nullStream(), .errorStream = &bench::nullStream()},
+                             gen::vector<int>({.elemGen = gen::interval(0, 10000), .minSize = size, .maxSize = size}));
+        benchmark::DoNotOptimize(result);
+        numItems++;
+    }
+    bench::reportItems(state, numItems, allocsBefore);
+}
+
+BENCHMARK(BM_ForAllShrink)->Arg(8)->Arg(64);
+
+// stateful runs per second; the benchmark argument is the number of actions per run
+static void BM_StatefulProperty(benchmark::State& state)
+{
+    using T = vector<int>;
+    const uint32_t numRuns = 10;
+    const size_t numActions = static_cast<size_t>(state.range(0));
+
+    auto pushBackGen = gen::int32().map<SimpleAction<T>>([](int value) {
+        return SimpleAction<T>(PROP_ACTION_NAME("PushBack", value), [value](T& obj) { obj.push_back(value); });
+    });
+    auto popBackAction = SimpleAction<T>("PopBack", [](T& obj) {
+        if (!obj.empty())
+            obj.pop_back();
+    });
+    auto clearAction = SimpleAction<T>("Clear", [](T& obj) { obj.clear(); });
+    auto actionGen = gen::oneOf<SimpleAction<T>>(pushBackGen, popBackAction, clearAction);
+
+    int64_t numItems = 0;
+    uint64_t allocsBefore = bench::allocationCount();
+    for (auto _ : state) {
+        auto prop = statefulProperty<T>(Arbi<T>(0, 8), actionGen);
+        prop.setSeed(1)
+            .setNumRuns(numRuns)
+            .setActionListSize(numActions)
+            .setOutputStreams(bench::nullStream(), bench::nullStream())
+            .go();
+        numItems += numRuns;
+    }
+    bench::reportItems(state, numItems, allocsBefore);
+}
+
+BENCHMARK(BM_StatefulProperty)->Arg(10)->Arg(100)->Arg(1000);
+
+// cost of a passing expectation, including a streamed message that is never formatted
+static void BM_PropExpectPass(benchmark::State& state)
+{
+    int value = 0;
+    uint64_t allocsBefore = bench::allocationCount();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(value);
+        PROP_EXPECT_EQ(value, 0) << "value: " << value;
+    }
+    bench::reportItems(state, state.iterations(), allocsBefore);
+}
+
+BENCHMARK(BM_PropExpectPass);
+
+// forAll runs per second of a cheap property that records a bool and an integer statistic
+static void BM_ForAllStat(benchmark::State& state)
+{
+    const uint32_t numRuns = 100;
+    int64_t numItems = 0;
+    uint64_t allocsBefore = bench::allocationCount();
+    for (auto _ : state) {
+        bool result = forAll([](int a) {
+                                 PROP_STAT(a > 0);
+                                 PROP_TAG("a % 4", a % 4);
+                             },
+                             {.seed = 1, .numRuns = numRuns, .outputStream = &bench::nullStream(),
+                              .errorStream = &bench::nullStream()});
+        benchmark::DoNotOptimize(result);
+        numItems += numRuns;
+    }
+    bench::reportItems(state, numItems, allocsBefore);
+}
+
+BENCHMARK(BM_ForAllStat);
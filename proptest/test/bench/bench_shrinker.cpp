@@ -0,0 +1,75 @@
+#include "proptest/test/bench/bench_util.hpp"
+#include "proptest/proptest.hpp"
+#include "proptest/shrinker/integral.hpp"
+#include "proptest/shrinker/floating.hpp"
+#include "proptest/shrinker/string.hpp"
+
+using namespace proptest;
+
+// shrink candidates per second: each iteration walks a whole shrink path from a fresh root
+template <typename T>
+static void runShrinkBenchmark(benchmark::State& state, Function<Shrinkable<T>()> makeRoot)
+{
+    int64_t numCandidates = 0;
+    uint64_t allocsBefore = bench::allocationCount();
+    for (auto _ : state)
+        numCandidates += bench::walkShrinks(makeRoot());
+    bench::reportItems(state, numCandidates, allocsBefore);
+}
+
+static void BM_ShrinkIntegral(benchmark::State& state)
+{
+    const int64_t value = state.range(0);
+    runShrinkBenchmark<int64_t>(state, [value]() { return shrinkIntegral<int64_t>(value); });
+}
+
+BENCHMARK(BM_ShrinkIntegral)->Arg(100)->Arg(1 << 20)->Arg(INT64_MAX);
+
+static void BM_ShrinkFloat(benchmark::State& state)
+{
+    runShrinkBenchmark<double>(state, []() { return shrinkFloat<double>(12345.678); });
+}
+
+BENCHMARK(BM_ShrinkFloat);
+
+static void BM_ShrinkString(benchmark::State& state)
+{
+    const string str(static_cast<size_t>(state.range(0)), 'x');
+    runShrinkBenchmark<string>(state, [str]() { return shrinkString(str); });
+}
+
+BENCHMARK(BM_ShrinkString)->Arg(8)->Arg(64)->Arg(512);
+
+// the shrink tree of a generated value depends on its elements; the seed keeps it fixed across runs
+template <typename T>
+static void runGeneratedShrinkBenchmark(benchmark::State& state, const Arbi<T>& arbi)
+{
+    Random rand(1);
+    auto root = arbi(rand);
+    runShrinkBenchmark<T>(state, [root]() { return root; });
+}
+
+static void BM_ShrinkVector(benchmark::State& state)
+{
+    const size_t size = static_cast<size_t>(state.range(0));
+    runGeneratedShrinkBenchmark(state, Arbi<vector<int>>(size, size));
+}
+
+BENCHMARK(BM_ShrinkVector)->Arg(8)->Arg(64)->Arg(512);
+
+static void BM_ShrinkList(benchmark::State& state)
+{
+    const size_t size = static_cast<size_t>(state.range(0));
+    runGeneratedShrinkBenchmark(state, Arbi<list<int>>(size, size));
+}
+
+BENCHMARK(BM_ShrinkList)->Arg(8)->Arg(64);
+
+using IntStringTuple = tuple<int, string>;
+
+static void BM_ShrinkTuple(benchmark::State& state)
+{
+    runGeneratedShrinkBenchmark(state, Arbi<IntStringTuple>());
+}
+
+BENCHMARK(BM_ShrinkTuple);
@@ -0,0 +1,109 @@
+#include "proptest/test/bench/bench_util.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> numAllocations{0};
+
+}  // namespace
+
+namespace {
+
+void* countedAlloc(std::size_t size)
+{
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* countedAlignedAlloc(std::size_t size, std::align_val_t align)
+{
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t alignment = static_cast<std::size_t>(align);
+    // aligned_alloc wants a multiple of the alignment
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+}  // namespace
+
+// count every allocation of the process, including over-aligned and nothrow ones (e.g. shrink arena chunks); the
+// benchmarks report the difference per item. Array forms forward to these.
+void* operator new(std::size_t size)
+{
+    if (void* ptr = countedAlloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    if (void* ptr = countedAlignedAlloc(size, align))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+    return countedAlignedAlloc(size, align);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+namespace proptest {
+namespace bench {
+
+uint64_t allocationCount()
+{
+    return numAllocations.load(std::memory_order_relaxed);
+}
+
+ostream& nullStream()
+{
+    static std::ostream stream(nullptr);
+    return stream;
+}
+
+void reportItems(benchmark::State& state, int64_t numItems, uint64_t allocsBefore)
+{
+    state.SetItemsProcessed(numItems);
+    if (numItems > 0)
+        state.counters["allocs_per_item"] =
+            static_cast<double>(allocationCount() - allocsBefore) / static_cast<double>(numItems);
+}
+
+}  // namespace bench
+}  // namespace proptest
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "proptest/Shrinkable.hpp"
+#include "proptest/std/io.hpp"
+#include <benchmark/benchmark.h>
+
+/**
+ * @file bench_util.hpp
+ * @brief Helpers shared by the bench_proptest benchmarks
+ */
+
+namespace proptest {
+namespace bench {
+
+/// Number of calls to the global operator new so far, in all its forms (counted in bench_util.cpp)
+uint64_t allocationCount();
+
+/// Stream that discards everything, for silencing property output
+ostream& nullStream();
+
+/**
+ * @brief Sets items processed and reports allocations per item as the "allocs_per_item" counter
+ * @param allocsBefore allocationCount() taken before the benchmark loop
+ */
+void reportItems(benchmark::State& state, int64_t numItems, uint64_t allocsBefore);
+
+/**
+ * @brief Walks a shrink tree the way a failing property would be shrunk, and returns the number of candidates visited
+ *
+ * Every candidate of a level is pulled from the stream, then the walk continues into the last one, as if only that
+ * candidate had failed. This visits most candidates of each level and always terminates at a leaf.
+ */
+template <typename T>
+int64_t walkShrinks(const Shrinkable<T>& root)
+{
+    int64_t numCandidates = 0;
+    Shrinkable<T> cur = root;
+    while (true) {
+        auto shrinks = cur.getShrinks();
+        if (shrinks.isEmpty())
+            break;
+        Shrinkable<T> last = cur;
+        for (auto itr = shrinks.template iterator<typename Shrinkable<T>::StreamElementType>(); itr.hasNext();) {
+            last = itr.next();
+            benchmark::DoNotOptimize(last.getRef());
+            numCandidates++;
+        }
+        cur = last;
+    }
+    return numCandidates;
+}
+
+}  // namespace bench
+}  // namespace proptest
@@ -529,6 +529,84 @@ TEST(Any, noncopyable_via_make_any)
     ASSERT_EQ(copiedAny.getRef<NonCopyable>().value, 100);
 }
 
+struct SmallTrivial {
+    int a;
+    double b;
+};
+
+struct LargeTrivial {
+    int64_t values[4];
+};
+
+TEST(Any, small_trivially_copyable_stored_by_value)
+{
+    Any any = SmallTrivial{1, 2.5};
+    ASSERT_EQ(any.type(), typeid(SmallTrivial));
+    ASSERT_EQ(any.getRef<SmallTrivial>().a, 1);
+    ASSERT_EQ(any.getRef<SmallTrivial>().b, 2.5);
+
+    Any copy = any;
+    copy.getMutableRef<SmallTrivial>().a = 2;
+    EXPECT_EQ(any.getRef<SmallTrivial>().a, 1);
+    EXPECT_EQ(copy.getRef<SmallTrivial>().a, 2);
+
+    Any cloned = any.clone();
+    EXPECT_EQ(cloned.getRef<SmallTrivial>().a, 1);
+    EXPECT_THROW(any.getRef<int>(), invalid_cast_error);
+}
+
+TEST(Any, large_trivially_copyable_uses_holder)
+{
+    Any any = LargeTrivial{{1, 2, 3, 4}};
+    ASSERT_EQ(any.type(), typeid(LargeTrivial));
+    EXPECT_EQ(any.getRef<LargeTrivial>().values[3], 4);
+    Any cloned = any.clone();
+    EXPECT_EQ(cloned.getRef<LargeTrivial>().values[0], 1);
+
+    // a write to a copy is not seen by the original, as with inline values
+    Any copy = any;
+    copy.getMutableRef<LargeTrivial>().values[0] = 5;
+    EXPECT_EQ(any.getRef<LargeTrivial>().values[0], 1);
+    EXPECT_EQ(copy.getRef<LargeTrivial>().values[0], 5);
+}
+
+TEST(Any, assignment_between_inline_and_empty)
+{
+    Any any;
+    any = Any(3);
+    EXPECT_EQ(any.getRef<int>(), 3);
+    any = Any::empty;
+    EXPECT_TRUE(any.isEmpty());
+    any = Any(string("hello"));
+    EXPECT_EQ(any.getRef<string>(), "hello");
+    EXPECT_THROW(any = Any(1), invalid_cast_error);
+}
+
+TEST(Any, holder_value_access_after_copy_and_assignment)
+{
+    Any any = string("hello");
+    Any copy = any;
+    EXPECT_EQ(&copy.getRef<string>(), &any.getRef<string>());
+    copy.getMutableRef<string>() += " world";
+    // copies share a holder until one is written to, as copies of an inline value do not share at all
+    EXPECT_EQ(any.getRef<string>(), "hello");
+    EXPECT_EQ(copy.getRef<string>(), "hello world");
+    any.getMutableRef<string>() += "!";
+    EXPECT_EQ(any.getRef<string>(), "hello!");
+    EXPECT_EQ(copy.getRef<string>(), "hello world");
+
+    Any cloned = any.clone();
+    cloned.getMutableRef<string>() = "cloned";
+    EXPECT_EQ(any.getRef<string>(), "hello!");
+    EXPECT_EQ(cloned.getRef<string>(), "cloned");
+
+    Any assigned = Any(string("other"));
+    assigned = cloned;
+    EXPECT_EQ(assigned.getRef<string>(), "cloned");
+    EXPECT_THROW(assigned.getRef<int>(), invalid_cast_error);
+    EXPECT_THROW(Any::empty.getRef<int>(), invalid_cast_error);
+}
+
 TEST(Any, int_performance)
 {
     for(int i = 0; i < 1000000; i++)
@@ -248,6 +248,14 @@ TEST(Arbitrary, string_default)
     for(int i = 0; i < 100; i++) {
         auto str = arbi(rand).getRef();
         EXPECT_LE(str.size(), Arbi<string>::defaultMaxSize);
+        for(auto c : str) {
+            EXPECT_TRUE(c >= 0x1 && c <= 0x7f);
+        }
+    }
+    // the bulk draws are reproducible like the per-character ones
+    Random rand1(7), rand2(7);
+    for(int i = 0; i < 10; i++) {
+        EXPECT_EQ(arbi(rand1).getRef(), arbi(rand2).getRef());
     }
 
     auto arbi2 = Arbi<string>(Arbi<char>());
@@ -0,0 +1,79 @@
+#include "proptest/util/arena.hpp"
+#include "proptest/util/any.hpp"
+#include "proptest/util/function.hpp"
+#include "proptest/std/string.hpp"
+#include "proptest/std/thread.hpp"
+#include "proptest/std/vector.hpp"
+#include <array>
+#include "proptest/test/gtest.hpp"
+
+using namespace proptest;
+
+TEST(ShrinkArena, nodes_allocated_within_scope)
+{
+    util::ShrinkArenaScope scope;
+    vector<Any> values;
+    for (int i = 0; i < 10000; i++)
+        values.push_back(Any(to_string(i)));
+    EXPECT_GT(scope.arena().numChunks(), 0U);
+    for (int i = 0; i < 10000; i++)
+        EXPECT_EQ(values[i].getRef<string>(), to_string(i));
+}
+
+TEST(ShrinkArena, nested_scopes_use_their_own_arena)
+{
+    util::ShrinkArenaScope scope;
+    {
+        util::ShrinkArenaScope inner;
+        Any any(string("inner"));
+        EXPECT_EQ(inner.arena().numChunks(), 1U);
+    }
+    EXPECT_EQ(scope.arena().numChunks(), 0U);
+}
+
+TEST(ShrinkArena, nodes_outlive_scope)
+{
+    Any escaped;
+    Function<string()> func;
+    {
+        util::ShrinkArenaScope scope;
+        escaped = Any(string("escaped"));
+        string captured(100, 'x');
+        func = [captured]() { return captured; };
+    }
+    // chunks stay alive until the last node drawn from them is released
+    EXPECT_EQ(escaped.getRef<string>(), "escaped");
+    EXPECT_EQ(func().size(), 100U);
+}
+
+TEST(ShrinkArena, nodes_released_on_other_thread)
+{
+    vector<Any> values;
+    {
+        util::ShrinkArenaScope scope;
+        for (int i = 0; i < 1000; i++)
+            values.push_back(Any(vector<int>(10, i)));
+    }
+    thread t([&values]() { values.clear(); });
+    t.join();
+    EXPECT_TRUE(values.empty());
+}
+
+TEST(ShrinkArena, large_nodes_bypass_chunks)
+{
+    util::ShrinkArenaScope scope;
+    Any large(vector<char>(10, 'x'));
+    auto node = util::make_shared_node<std::array<char, util::ShrinkArena::maxChunkAllocation + 1>>();
+    EXPECT_EQ(scope.arena().numChunks(), 1U);
+    EXPECT_EQ(large.getRef<vector<char>>().size(), 10U);
+}
+
+TEST(ShrinkArena, allocator_without_arena_uses_heap)
+{
+    util::ShrinkArenaAllocator<int> alloc;
+    int* values = alloc.allocate(4);
+    values[3] = 3;
+    EXPECT_EQ(values[3], 3);
+    alloc.deallocate(values, 4);
+    EXPECT_EQ(util::ShrinkArena::active(), nullptr);
+}
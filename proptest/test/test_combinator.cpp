@@ -2,6 +2,7 @@
 #include "proptest/gen.hpp"
 #include "proptest/std/string.hpp"
 #include "proptest/Random.hpp"
+#include "proptest/util/alias_table.hpp"
 #include "proptest/test/gtest.hpp"
 #include "proptest/test/testutil.hpp"
 
@@ -141,6 +142,37 @@ TEST(ElementOf, weighted)
     EXPECT_GT(num1339, num42);
 }
 
+TEST(AliasTable, frequencies)
+{
+    Random rand(1);
+    util::AliasTable table({1.0, 2.0, 3.0, 0.0, 4.0, 1e-6});
+    ASSERT_EQ(table.size(), 6U);
+    const int numPicks = 100000;
+    vector<int> counts(table.size(), 0);
+    for (int i = 0; i < numPicks; i++)
+        counts[table.pick(rand)]++;
+    const double expected[] = {0.1, 0.2, 0.3, 0.0, 0.4};
+    for (size_t i = 0; i < 5; i++)
+        EXPECT_NEAR(static_cast<double>(counts[i]) / numPicks, expected[i], 0.01) << "index " << i;
+    EXPECT_EQ(counts[3], 0);
+
+    EXPECT_THROW(util::AliasTable({}), runtime_error);
+    EXPECT_THROW(util::AliasTable({0.0, 0.0}), runtime_error);
+    EXPECT_THROW(util::AliasTable({1.0, -1.0}), runtime_error);
+}
+
+TEST(ElementOf, weightsBelowOneAreNormalized)
+{
+    Random rand(1);
+    // every weight given but summing to 0.5: chosen in proportion 0.2 : 0.3
+    auto gen = gen::elementOf<int>(gen::weightedVal(1, 0.2), gen::weightedVal(2, 0.3));
+    int num1 = 0;
+    for (int i = 0; i < 10000; i++)
+        if (gen(rand).getRef() == 1)
+            num1++;
+    EXPECT_NEAR(num1 / 10000.0, 0.4, 0.03);
+}
+
 TEST(Filter, basic)
 {
     Random rand(getCurrentTime());
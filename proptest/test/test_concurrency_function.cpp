@@ -296,6 +296,79 @@ TEST(concurrency_function, shrink_last_action_params)
         << "\nactual output:\n" << output;
 }
 
+/**
+ * Rears run on threads kept by the property: across all runs, no more threads than
+ * maxConcurrency ever execute rear actions.
+ */
+TEST(concurrency_function, rear_threads_are_reused_across_runs)
+{
+    constexpr uint32_t NUM_THREADS = 3;
+    const auto mainThread = std::this_thread::get_id();
+    auto threadIds = util::make_shared<set<std::thread::id>>();
+    auto idsMutex = util::make_shared<mutex>();
+
+    auto recordGen = gen::just(SimpleAction<int>("Record", [=](int&) {
+        if (std::this_thread::get_id() == mainThread)
+            return;
+        lock_guard<mutex> guard(*idsMutex);
+        threadIds->insert(std::this_thread::get_id());
+    }));
+
+    auto prop = statefulProperty<int>(gen::just(0), recordGen);
+    std::ostringstream out;
+    bool ok = prop.setSeed(1)
+                  .setNumRuns(100)
+                  .setMaxConcurrency(NUM_THREADS)
+                  .setActionListMinSize(1)
+                  .setActionListMaxSize(3)
+                  .setOutputStreams(out, out)
+                  .go();
+
+    EXPECT_TRUE(ok) << out.str();
+    EXPECT_GT(threadIds->size(), 0U);
+    EXPECT_LE(threadIds->size(), NUM_THREADS);
+}
+
+/**
+ * StartGate releases no thread before the last one has arrived, in every wait mode,
+ * and the rears of a concurrent property run behind it in each mode.
+ */
+TEST(concurrency_function, start_gate_releases_after_all_arrive)
+{
+    constexpr uint32_t NUM_THREADS = 4;
+    for (auto mode : {util::StartGateMode::SpinThenBlock, util::StartGateMode::Spin, util::StartGateMode::Block}) {
+        for (int round = 0; round < 20; round++) {
+            util::StartGate gate(NUM_THREADS, mode, 16);
+            atomic<uint32_t> numArrived(0);
+            atomic<uint32_t> numEarly(0);
+            vector<std::thread> threads;
+            for (uint32_t i = 0; i < NUM_THREADS; i++) {
+                threads.emplace_back([&]() {
+                    numArrived++;
+                    gate.arriveAndWait();
+                    if (numArrived.load() != NUM_THREADS)
+                        numEarly++;
+                });
+            }
+            for (auto& thr : threads)
+                thr.join();
+            EXPECT_TRUE(gate.isOpen());
+            EXPECT_EQ(numEarly.load(), 0U) << "mode " << static_cast<int>(mode);
+        }
+
+        auto incGen = gen::just(SimpleAction<int>("Inc", [](int&) {}));
+        std::ostringstream out;
+        bool ok = statefulProperty<int>(gen::just(0), incGen)
+                      .setSeed(1)
+                      .setNumRuns(20)
+                      .setMaxConcurrency(NUM_THREADS)
+                      .setStartGateMode(mode)
+                      .setOutputStreams(out, out)
+                      .go();
+        EXPECT_TRUE(ok) << out.str();
+    }
+}
+
 /**
  * Verifies state-dependent action factory for concurrency: front actions are generated
  * and executed with interleaved factory calls; rear actions are pre-generated against
@@ -526,3 +599,223 @@ TEST(concurrency_function, shrink_prefix_params_rear_thread)
         << " (rear PrefixParams code path exercised without crash)"
         << "\nactual output:\n" << out.str();
 }
+
+namespace {
+
+/// counters a concurrent run can share; copies (taken while no thread runs) get their own counters
+struct SharedCounters
+{
+    SharedCounters() = default;
+    SharedCounters(const SharedCounters& other) { *this = other; }
+    SharedCounters& operator=(const SharedCounters& other)
+    {
+        for (size_t i = 0; i < 2; i++)
+            values[i].store(other.values[i].load());
+        return *this;
+    }
+
+    friend ostream& operator<<(ostream& os, const SharedCounters& counters)
+    {
+        return os << "{ " << counters.values[0].load() << ", " << counters.values[1].load() << " }";
+    }
+
+    atomic<int> values[2] = {0, 0};
+};
+
+struct CountersModel
+{
+    int values[2] = {0, 0};
+
+    bool operator==(const CountersModel& other) const
+    {
+        return values[0] == other.values[0] && values[1] == other.values[1];
+    }
+};
+
+/// a model the checker cannot memoize
+struct UnhashedModel
+{
+    int value = 0;
+};
+
+}  // namespace
+
+template <>
+struct std::hash<CountersModel>
+{
+    size_t operator()(const CountersModel& model) const
+    {
+        return std::hash<int>{}(model.values[0]) * 31 + std::hash<int>{}(model.values[1]);
+    }
+};
+
+namespace {
+
+template <typename ModelType>
+LinearizableCall<ModelType> writeCall(int threadId, uint64_t invokedAt, uint64_t respondedAt, int value)
+{
+    return {threadId, invokedAt, respondedAt, "Write", 0, [value](ModelType& model) {
+                model.values[0] = value;
+                return true;
+            }};
+}
+
+template <typename ModelType>
+LinearizableCall<ModelType> readCall(int threadId, uint64_t invokedAt, uint64_t respondedAt, int observed)
+{
+    return {threadId, invokedAt, respondedAt, "Read", 0,
+            [observed](ModelType& model) { return model.values[0] == observed; }};
+}
+
+/// the runs keep incrementing the same object, so the model starts from its counts
+const auto countersModel = [](const SharedCounters& counters) {
+    return CountersModel{{counters.values[0].load(), counters.values[1].load()}};
+};
+
+/// counter increment, as a read followed by a write (racy=true) or as one atomic step
+Action<SharedCounters, CountersModel> incrementAction(size_t key, bool racy)
+{
+    return Action<SharedCounters, CountersModel>(
+        PROP_ACTION_NAME("Inc", key), [key, racy](SharedCounters& counters, CountersModel&, Context& context) {
+            int before;
+            if (racy) {
+                before = counters.values[key].load();
+                std::this_thread::yield();
+                counters.values[key].store(before + 1);
+            } else {
+                before = counters.values[key].fetch_add(1);
+            }
+            context.linearize<CountersModel>(
+                [key, before](CountersModel& model) { return model.values[key]++ == before; }, key);
+        });
+}
+
+}  // namespace
+
+/**
+ * The checker accepts a history if and only if some order that keeps the real-time order of the calls agrees with
+ * the model, with or without memoization.
+ */
+TEST(concurrency_function, linearizability_checker_histories)
+{
+    using Call = LinearizableCall<CountersModel>;
+    LinearizabilityChecker<CountersModel> checker;
+
+    // a read overlapping a write may see it
+    vector<Call> overlapping = {writeCall<CountersModel>(0, 0, 3, 1), readCall<CountersModel>(1, 1, 2, 1)};
+    EXPECT_EQ(checker.check(CountersModel{}, overlapping), Linearizability::Linearizable);
+
+    // a read invoked after a write responded may not miss it
+    vector<Call> stale = {writeCall<CountersModel>(0, 0, 1, 1), readCall<CountersModel>(1, 2, 3, 0)};
+    EXPECT_EQ(checker.check(CountersModel{}, stale), Linearizability::NotLinearizable);
+    EXPECT_EQ(checker.getFailedCalls().size(), 2U);
+
+    // two reads during one write may not see it and then not see it
+    vector<Call> flickering = {writeCall<CountersModel>(0, 0, 5, 1), readCall<CountersModel>(1, 1, 2, 1),
+                               readCall<CountersModel>(1, 3, 4, 0)};
+    EXPECT_EQ(checker.check(CountersModel{}, flickering), Linearizability::NotLinearizable);
+
+    LinearizabilityChecker<UnhashedModel> unhashedChecker;
+    vector<LinearizableCall<UnhashedModel>> unhashedStale = {
+        {0, 0, 1, "Write", 0, [](UnhashedModel& model) { return (model.value = 1) == 1; }},
+        {1, 2, 3, "Read", 0, [](UnhashedModel& model) { return model.value == 0; }}};
+    EXPECT_EQ(unhashedChecker.check(UnhashedModel{}, unhashedStale), Linearizability::NotLinearizable);
+
+    // calls of different partitions are checked on their own; each partition here is fine by itself
+    vector<Call> partitioned = {writeCall<CountersModel>(0, 0, 1, 1), readCall<CountersModel>(1, 2, 3, 1)};
+    partitioned[0].partition = 1;
+    partitioned[1].partition = 2;
+    EXPECT_EQ(checker.check(CountersModel{}, partitioned), Linearizability::NotLinearizable);
+    partitioned[1].step = [](CountersModel& model) { return model.values[0] == 0; };
+    EXPECT_EQ(checker.check(CountersModel{}, partitioned), Linearizability::Linearizable);
+}
+
+/**
+ * Memoization keeps the search over overlapping calls polynomial in the number of orders that lead to the same
+ * state: n overlapping increments and a read that can see none of their counts visit about 2^n states, not n!.
+ */
+TEST(concurrency_function, linearizability_checker_memoizes_dead_ends)
+{
+    using Call = LinearizableCall<CountersModel>;
+    constexpr int NUM_INCREMENTS = 10;
+    vector<Call> calls;
+    for (int i = 0; i < NUM_INCREMENTS; i++) {
+        calls.push_back({i, static_cast<uint64_t>(i), 100, "Inc", 0, [](CountersModel& model) {
+                             model.values[0]++;
+                             return true;
+                         }});
+    }
+    calls.push_back(readCall<CountersModel>(NUM_INCREMENTS, 50, 60, -1));
+
+    LinearizabilityChecker<CountersModel> checker;
+    EXPECT_EQ(checker.check(CountersModel{}, calls), Linearizability::NotLinearizable);
+    EXPECT_LE(checker.getNumStates(), 1U << NUM_INCREMENTS);
+
+    LinearizabilityChecker<CountersModel> smallChecker(100);
+    EXPECT_EQ(smallChecker.check(CountersModel{}, calls), Linearizability::Inconclusive);
+
+    // without memory for the memo, the search reaches the same result through more states
+    constexpr int NUM_FEW_INCREMENTS = 6;
+    vector<Call> fewCalls(calls.begin(), calls.begin() + NUM_FEW_INCREMENTS);
+    fewCalls.push_back(calls.back());
+    LinearizabilityChecker<CountersModel> unmemoizedChecker(LinearizabilityChecker<CountersModel>::defaultMaxStates, 0);
+    EXPECT_EQ(unmemoizedChecker.check(CountersModel{}, fewCalls), Linearizability::NotLinearizable);
+    EXPECT_GT(unmemoizedChecker.getNumStates(), 1U << NUM_FEW_INCREMENTS);
+}
+
+/**
+ * An increment made of a separate read and write loses updates when rears overlap; each rear alone and postCheck
+ * see nothing wrong, but the history has no linearization.
+ */
+TEST(concurrency_function, linearizability_check_finds_lost_updates)
+{
+    auto actionGen = gen::just(incrementAction(0, true));
+    std::ostringstream out;
+    bool ok = statefulProperty<SharedCounters, CountersModel>(
+                  gen::just(SharedCounters()), countersModel, actionGen)
+                  .setSeed(1)
+                  .setNumRuns(200)
+                  .setMaxConcurrency(3)
+                  .setActionListMinSize(2)
+                  .setActionListMaxSize(10)
+                  .setLinearizabilityCheck(true)
+                  .setOutputStreams(out, out)
+                  .go();
+    EXPECT_FALSE(ok);
+    EXPECT_NE(out.str().find("not linearizable"), string::npos) << out.str();
+
+    // a search that runs out of states gives up without failing the run
+    std::ostringstream limitedOut;
+    ok = statefulProperty<SharedCounters, CountersModel>(gen::just(SharedCounters()), countersModel, actionGen)
+             .setSeed(1)
+             .setNumRuns(20)
+             .setMaxConcurrency(3)
+             .setActionListMinSize(2)
+             .setActionListMaxSize(10)
+             .setLinearizabilityCheck(true)
+             .setLinearizabilityMaxStates(1)
+             .setOutputStreams(limitedOut, limitedOut)
+             .go();
+    EXPECT_TRUE(ok) << limitedOut.str();
+}
+
+/**
+ * Atomic increments on two counters are linearizable; the key given to linearize() lets each counter be checked
+ * on its own.
+ */
+TEST(concurrency_function, linearizability_check_passes_atomic_increments)
+{
+    auto actionGen = gen::elementOf<Action<SharedCounters, CountersModel>>(incrementAction(0, false),
+                                                                          incrementAction(1, false));
+    std::ostringstream out;
+    bool ok = statefulProperty<SharedCounters, CountersModel>(
+                  gen::just(SharedCounters()), countersModel, actionGen)
+                  .setSeed(1)
+                  .setNumRuns(200)
+                  .setMaxConcurrency(3)
+                  .setActionListMaxSize(10)
+                  .setLinearizabilityCheck(true)
+                  .setOutputStreams(out, out)
+                  .go();
+    EXPECT_TRUE(ok) << out.str();
+}
@@ -230,3 +230,73 @@ TEST(Function, incompatible_const_ref_arg)
     Function<int(const int&)> constFunc = constLambda;
     Function<int(int&)> func2 = constFunc;
 }
+
+TEST(Function, inline_and_shared_captures)
+{
+    int small = 1;
+    Function<int(int)> inlineFunc = [small](int a) { return a + small; };
+    struct Large { int64_t values[8]; } large = {{1, 2, 3, 4, 5, 6, 7, 8}};
+    Function<int(int)> sharedFunc = [large](int a) { return a + static_cast<int>(large.values[7]); };
+
+    Function<int(int)> copy1 = inlineFunc;
+    Function<int(int)> copy2 = sharedFunc;
+    EXPECT_EQ(copy1(1), 2);
+    EXPECT_EQ(copy2(1), 9);
+
+    copy1 = sharedFunc;
+    copy2 = inlineFunc;
+    EXPECT_EQ(copy1(1), 9);
+    EXPECT_EQ(copy2(1), 2);
+
+    inlineFunc = inlineFunc;
+    EXPECT_EQ(inlineFunc(1), 2);
+}
+
+TEST(Function, inline_capture_released_with_last_copy)
+{
+    auto counter = util::make_shared<int>(0);
+    {
+        Function<int()> function = [counter]() { return ++*counter; };
+        Function<int()> copy = function;
+        EXPECT_EQ(function(), 1);
+        EXPECT_EQ(copy(), 2);
+        EXPECT_EQ(counter.use_count(), 3);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(Function, mutable_callable_copies_do_not_share_state)
+{
+    // a copy of a mutable callable counts on its own, whether the callable is stored inline or not
+    Function<int()> inlineFunc = [n = 0]() mutable { return ++n; };
+    struct Large { int64_t values[8]; };
+    Function<int()> sharedFunc = [n = 0, large = Large{}]() mutable { return ++n + static_cast<int>(large.values[0]); };
+
+    EXPECT_EQ(inlineFunc(), 1);
+    EXPECT_EQ(sharedFunc(), 1);
+    Function<int()> inlineCopy = inlineFunc;
+    Function<int()> sharedCopy = sharedFunc;
+    EXPECT_EQ(inlineCopy(), 2);
+    EXPECT_EQ(sharedCopy(), 2);
+    EXPECT_EQ(inlineFunc(), 2);
+    EXPECT_EQ(sharedFunc(), 2);
+
+    Function1<int> inlineFunc1 = [n = 0](const int& a) mutable { return a + ++n; };
+    Function1<int> sharedFunc1 = [n = 0, large = Large{}](const int& a) mutable {
+        return a + ++n + static_cast<int>(large.values[0]);
+    };
+    Function1<int> inlineCopy1 = inlineFunc1;
+    Function1<int> sharedCopy1 = sharedFunc1;
+    EXPECT_EQ(inlineFunc1(Any(10)), 11);
+    EXPECT_EQ(sharedFunc1(Any(10)), 11);
+    EXPECT_EQ(inlineCopy1(Any(10)), 11);
+    EXPECT_EQ(sharedCopy1(Any(10)), 11);
+}
+
+TEST(Function, move_only_callable_is_shared)
+{
+    auto ptr = util::make_unique<int>(5);
+    Function<int()> function = [ptr = util::move(ptr)]() { return *ptr; };
+    Function<int()> copy = function;
+    EXPECT_EQ(copy(), 5);
+}
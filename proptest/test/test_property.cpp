@@ -5,6 +5,10 @@
 #include "proptest/combinator/combinators.hpp"
 #include "proptest/gen.hpp"
 #include "proptest/std/chrono.hpp"
+#include "proptest/std/limits.hpp"
+#include "proptest/std/math.hpp"
+#include "proptest/std/thread.hpp"
+#include "proptest/util/time_budget.hpp"
 
 using namespace proptest;
 
@@ -344,6 +348,39 @@ TEST(Property, expect_invoked_once_on_failure)
 
 }
 
+namespace {
+
+int numCountedMessageFormats = 0;
+
+struct CountedMessage
+{
+};
+
+ostream& operator<<(ostream& os, const CountedMessage&)
+{
+    numCountedMessageFormats++;
+    return os << "counted message";
+}
+
+}  // namespace
+
+TEST(Property, expect_message_formatted_only_on_failure)
+{
+    numCountedMessageFormats = 0;
+    // a passing expectation needs no property context and formats nothing
+    auto passed = PROP_EXPECT_EQ(1, 1) << CountedMessage{} << endl;
+    EXPECT_FALSE(passed.failed());
+    EXPECT_EQ(numCountedMessageFormats, 0);
+
+    stringstream out;
+    EXPECT_FALSE(forAll([](int x) {
+        PROP_EXPECT_LT(x, 0) << CountedMessage{};
+        return true;
+    }, {.seed = 1, .numRuns = 1, .outputStream = &out, .errorStream = &out}, gen::just(5)));
+    EXPECT_GT(numCountedMessageFormats, 0);
+    EXPECT_NE(out.str().find("counted message"), string::npos) << out.str();
+}
+
 TEST(Property, check_assert)
 {
     forAll([](string a, int i, string b) -> bool {
@@ -599,6 +636,588 @@ TEST(Property, StatAssertInRangeFails)
     }, gen::interval(1, 100)));
 }
 
+TEST(Property, tagSummaryCountsNumericAndTextValues)
+{
+    stringstream out;
+    int numEven = 0;
+    EXPECT_TRUE(forAll([&numEven](int x) {
+        if (x % 2 == 0)
+            numEven++;
+        PROP_STAT(x % 2 == 0);
+        // the same value recorded as a number and as text is one entry in the summary
+        PROP_TAG("parity", x % 2);
+        PROP_TAG("parity", x % 2 ? "1" : "0");
+        PROP_TAG('c', x % 2 == 0);
+    }, {.seed = 1, .numRuns = 100, .outputStream = &out}, gen::interval(0, 3)));
+
+    const string summary = out.str();
+    stringstream evens, odds;
+    evens << "    true: " << numEven << "/100 (";
+    odds << "    1: " << 2 * (100 - numEven) << "/200 (";
+    EXPECT_NE(summary.find("  x % 2 == 0: \n"), string::npos) << summary;
+    EXPECT_NE(summary.find(evens.str()), string::npos) << summary;
+    EXPECT_NE(summary.find("  parity: \n"), string::npos) << summary;
+    EXPECT_NE(summary.find(odds.str()), string::npos) << summary;
+    EXPECT_NE(summary.find("  c: \n"), string::npos) << summary;
+}
+
+TEST(Property, statAssertCountsTrueTags)
+{
+    // a is never positive, but "true" recorded as text under the same key counts as well
+    EXPECT_TRUE(forAll([](int a) {
+        PROP_TAG("a > 0", "true");
+        PROP_STAT_ASSERT_GE(a > 0, 0.5);
+        return true;
+    }, {.numRuns = 10}, gen::interval(-100, -1)));
+}
+
+TEST(NumericStat, momentsAndExtremes)
+{
+    NumericStat stat;
+    for (int i = 1; i <= 100; i++)
+        stat.add(i);
+    EXPECT_EQ(stat.getCount(), 100U);
+    EXPECT_DOUBLE_EQ(stat.getMean(), 50.5);
+    EXPECT_NEAR(stat.getVariance(), 833.25, 1e-9);
+    EXPECT_EQ(stat.getMin(), 1.0);
+    EXPECT_EQ(stat.getMax(), 100.0);
+}
+
+TEST(NumericStat, quantilesWithinRelativeAccuracy)
+{
+    NumericStat stat;
+    for (int i = -1000; i <= 9000; i++)
+        stat.add(i);
+    EXPECT_NEAR(stat.getQuantile(0.5), 4000.0, 40.0);
+    EXPECT_NEAR(stat.getQuantile(0.9), 8000.0, 80.0);
+    EXPECT_NEAR(stat.getQuantile(0.05), -500.0, 5.0);
+    EXPECT_EQ(stat.getQuantile(0.0), -1000.0);
+    EXPECT_EQ(stat.getQuantile(1.0), 9000.0);
+}
+
+TEST(NumericStat, mergeMatchesSequential)
+{
+    NumericStat all, first, second;
+    for (int i = 0; i < 1000; i++) {
+        const double value = (i * 7919) % 1000 * 0.5 - 100.0;
+        all.add(value);
+        (i % 3 == 0 ? first : second).add(value);
+    }
+    first.merge(second);
+    EXPECT_EQ(first.getCount(), all.getCount());
+    EXPECT_NEAR(first.getMean(), all.getMean(), 1e-9);
+    EXPECT_NEAR(first.getVariance(), all.getVariance(), 1e-6);
+    EXPECT_EQ(first.getMin(), all.getMin());
+    EXPECT_EQ(first.getMax(), all.getMax());
+    EXPECT_EQ(first.getQuantile(0.5), all.getQuantile(0.5));
+}
+
+TEST(NumericStat, nonFiniteValuesAreOnlyCounted)
+{
+    NumericStat stat;
+    stat.add(1.0);
+    stat.add(numeric_limits<double>::quiet_NaN());
+    stat.add(numeric_limits<double>::infinity());
+    stat.add(3.0);
+    EXPECT_EQ(stat.getCount(), 2U);
+    EXPECT_EQ(stat.getNonFiniteCount(), 2U);
+    EXPECT_DOUBLE_EQ(stat.getMean(), 2.0);
+    EXPECT_EQ(stat.getMax(), 3.0);
+}
+
+TEST(NumericStat, bucketsStayBounded)
+{
+    // values spread over the whole double range would otherwise need tens of thousands of buckets
+    NumericStat stat;
+    for (int exp = -300; exp <= 300; exp++) {
+        for (int i = 1; i <= 9; i++)
+            stat.add(i * pow(10.0, exp));
+    }
+    EXPECT_EQ(stat.getCount(), 601U * 9U);
+    EXPECT_DOUBLE_EQ(stat.getQuantile(1.0), 9e300);
+    // the largest magnitudes keep their accuracy
+    EXPECT_NEAR(stat.getQuantile(0.99) / 8e294, 1.0, 0.02);
+}
+
+TEST(Property, statNumSummary)
+{
+    stringstream out;
+    EXPECT_TRUE(forAll([](int x) {
+        PROP_STAT_NUM(x);
+        PROP_STAT_NUM(x / 0.0);
+    }, {.seed = 1, .numRuns = 100, .outputStream = &out}, gen::interval(1, 100)));
+
+    const string summary = out.str();
+    EXPECT_NE(summary.find("  x: \n    count: 100, mean: "), string::npos) << summary;
+    EXPECT_NE(summary.find("    p50: "), string::npos) << summary;
+    EXPECT_NE(summary.find("  x / 0.0: \n    non-finite: 100\n"), string::npos) << summary;
+}
+
+TEST(Property, statNumAssertions)
+{
+    EXPECT_TRUE(forAll([](int a) {
+        PROP_STAT_NUM_ASSERT_IN_RANGE(a, MEAN, 40, 60);
+        PROP_STAT_NUM_ASSERT_GE(a, MIN, 0);
+        PROP_STAT_NUM_ASSERT_LE(a, P90, 100);
+        return true;
+    }, {.numRuns = 1000}, gen::interval(0, 100)));
+
+    stringstream err;
+    EXPECT_FALSE(forAll([](int a) {
+        PROP_STAT_NUM_ASSERT_GE(a, MEAN, 75);
+        return true;
+    }, {.numRuns = 1000, .errorStream = &err}, gen::interval(0, 100)));
+    EXPECT_NE(err.str().find("PROP_STAT_NUM_ASSERT_GE(a, MEAN, 75) failed: MEAN "), string::npos) << err.str();
+    EXPECT_NE(err.str().find("(1000 values)"), string::npos) << err.str();
+
+    // a measure of no values never satisfies its bounds
+    EXPECT_FALSE(forAll([](int a) {
+        PROP_STAT_NUM_ASSERT_LE(a / 0.0, MAX, 1);
+        return true;
+    }, {.numRuns = 10}, gen::interval(1, 100)));
+}
+
+TEST(Property, numThreadsRunsEveryTest)
+{
+    atomic<int> count{0};
+    stringstream out;
+    EXPECT_TRUE(forAll([&count](int) {
+        count++;
+        return true;
+    }, {.numRuns = 1001, .numThreads = 4, .outputStream = &out}));
+    EXPECT_EQ(count.load(), 1001);
+    EXPECT_NE(out.str().find("OK, passed 1001 tests"), string::npos);
+}
+
+TEST(Property, numThreadsStatAssertions)
+{
+    EXPECT_TRUE(forAll([](int a) {
+        PROP_STAT_ASSERT_GE(a > 0, 0.5);
+        return true;
+    }, {.numThreads = 3}, gen::interval(1, 100)));
+
+    EXPECT_FALSE(forAll([](int a) {
+        PROP_STAT_ASSERT_GE(a > 0, 0.5);
+        return true;
+    }, {.numThreads = 3}, gen::interval(-100, -1)));
+}
+
+TEST(Property, runStatsReportPhases)
+{
+    stringstream out;
+    auto result = property([](int) { return true; })
+                      .setNumRuns(50)
+                      .setOnStartup([]() {})
+                      .setOnCleanup([]() {})
+                      .setCollectRunStats(true)
+                      .setOutputStream(out)
+                      .forAll();
+    EXPECT_TRUE(result);
+    auto stats = result.getLastRunStats();
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->generation.count, 50U);
+    EXPECT_EQ(stats->function.count, 50U);
+    EXPECT_EQ(stats->startup.count, 50U);
+    EXPECT_EQ(stats->cleanup.count, 50U);
+    EXPECT_EQ(stats->shrink.count, 0U);
+    EXPECT_FALSE(stats->countsAllocations);
+    EXPECT_NE(out.str().find("run stats:\n  generation: 50 calls, "), string::npos) << out.str();
+
+    // not collected unless asked for
+    EXPECT_FALSE(property([](int) { return true; }).setNumRuns(1).setOutputStream(out).forAll().getLastRunStats());
+}
+
+TEST(Property, runStatsCountShrinkCandidates)
+{
+    optional<RunStats> reported;
+    stringstream out;
+    const bool ok = property([](int x) { return x < 50; })
+                        .setOnRunStats([&reported](RunStats stats) { reported = stats; })
+                        .setNumThreads(2)
+                        .setOutputStreams(out, out)
+                        .forAll(gen::interval(0, 1000));
+    EXPECT_FALSE(ok);
+    ASSERT_TRUE(reported.has_value());
+    EXPECT_GE(reported->generation.count, 1U);
+    EXPECT_EQ(reported->generation.count, reported->function.count);
+    EXPECT_EQ(reported->shrink.count, 1U);
+    EXPECT_GT(reported->numShrinkCandidates, 0U);
+    // only printed when enabled with setCollectRunStats
+    EXPECT_EQ(out.str().find("run stats:"), string::npos) << out.str();
+}
+
+namespace {
+
+uint64_t fakeAllocationCount = 0;
+
+// every read counts as one allocation, so each timed phase sees exactly one
+uint64_t countFakeAllocation()
+{
+    return fakeAllocationCount++;
+}
+
+}  // namespace
+
+TEST(Property, runStatsCountAllocations)
+{
+    util::setAllocationCounter(&countFakeAllocation);
+    stringstream out;
+    auto result = property([](int) { return true; }).setNumRuns(10).setCollectRunStats(true).setOutputStream(out).forAll();
+    util::setAllocationCounter(nullptr);
+
+    auto stats = result.getLastRunStats();
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_TRUE(stats->countsAllocations);
+    EXPECT_EQ(stats->generation.allocations, 10U);
+    EXPECT_EQ(stats->function.allocations, 10U);
+    EXPECT_NE(out.str().find("10 calls, "), string::npos) << out.str();
+    EXPECT_NE(out.str().find(", 10 allocations"), string::npos) << out.str();
+}
+
+TEST(TimeBudget, sharesRemainingTimeAcrossProperties)
+{
+    util::TimeBudget budget;
+    EXPECT_FALSE(budget.isActive());
+    EXPECT_EQ(budget.nextShareMs(), 0U);
+
+    budget.set(1000, 4);
+    EXPECT_TRUE(budget.isActive());
+    EXPECT_EQ(budget.nextShareMs(), 250U);
+    // a fast property leaves its unused time to the others
+    budget.charge(100);
+    EXPECT_EQ(budget.getRemainingMs(), 900U);
+    EXPECT_EQ(budget.nextShareMs(), 300U);
+    // a slow property leaves less
+    budget.charge(500);
+    EXPECT_EQ(budget.nextShareMs(), 200U);
+    budget.charge(1000);
+    EXPECT_EQ(budget.getRemainingMs(), 0U);
+    // properties beyond the announced count still get a minimal budget
+    EXPECT_EQ(budget.nextShareMs(), 1U);
+
+    budget.clear();
+    EXPECT_FALSE(budget.isActive());
+    EXPECT_EQ(budget.nextShareMs(), 0U);
+}
+
+TEST(TimeBudget, planNumRuns)
+{
+    // 10 runs took 20ms, so 40 more fit in the 100ms budget
+    EXPECT_EQ(util::planNumRuns(1000, 10, 20.0, 100), 50U);
+    EXPECT_EQ(util::planNumRuns(30, 10, 20.0, 100), 30U);
+    // too fast to measure
+    EXPECT_EQ(util::planNumRuns(1000, 10, 0.0, 100), 1000U);
+    // budget already used up
+    EXPECT_EQ(util::planNumRuns(1000, 10, 150.0, 100), 10U);
+    EXPECT_EQ(util::planNumRuns(5, 10, 150.0, 100), 5U);
+}
+
+TEST(Property, timeBudgetPlansNumRuns)
+{
+    stringstream out;
+    int numCalls = 0;
+    const bool ok = property([&numCalls](int) {
+                        numCalls++;
+                        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                        return true;
+                    })
+                        .setNumRuns(1000)
+                        .setTimeBudgetMs(100)
+                        .setOutputStream(out)
+                        .forAll();
+    EXPECT_TRUE(ok);
+    EXPECT_GE(numCalls, static_cast<int>(util::kBudgetCalibrationRuns));
+    EXPECT_LT(numCalls, 1000);
+    EXPECT_NE(out.str().find("Planned "), string::npos) << out.str();
+
+    // numRuns stays an upper bound
+    numCalls = 0;
+    EXPECT_TRUE(property([&numCalls](int) {
+                    numCalls++;
+                    return true;
+                })
+                    .setNumRuns(50)
+                    .setTimeBudgetMs(60000)
+                    .setOutputStream(out)
+                    .forAll());
+    EXPECT_EQ(numCalls, 50);
+}
+
+TEST(Property, timeBudgetChargesGlobalBudget)
+{
+    util::TimeBudget& budget = util::TimeBudget::global();
+    budget.set(60000, 2);
+    stringstream out;
+    EXPECT_TRUE(property([](int) { return true; }).setNumRuns(20).setOutputStream(out).forAll());
+    EXPECT_NE(out.str().find("Planned 20 runs for a time budget of 30000ms"), string::npos) << out.str();
+    // one property left, which takes all the remaining time
+    EXPECT_EQ(budget.nextShareMs(), budget.getRemainingMs());
+    EXPECT_GT(budget.getRemainingMs(), 50000U);
+    budget.clear();
+}
+
+TEST(Property, growSizeStartsWithSmallContainers)
+{
+    stringstream out;
+    vector<size_t> sizes;
+    EXPECT_TRUE(property([&sizes](vector<int> v) {
+                    sizes.push_back(v.size());
+                    return true;
+                })
+                    .setNumRuns(100)
+                    .setGrowSize(true)
+                    .setOutputStream(out)
+                    .forAll());
+    ASSERT_EQ(sizes.size(), 100U);
+    for (size_t i = 0; i < sizes.size(); i++)
+        EXPECT_LE(sizes[i], (i + 1) * 2) << "run " << i;
+    // the last runs reach the full size range
+    size_t maxLateSize = 0;
+    for (size_t i = 80; i < sizes.size(); i++)
+        maxLateSize = sizes[i] > maxLateSize ? sizes[i] : maxLateSize;
+    EXPECT_GT(maxLateSize, 100U);
+
+    // a failure found at a small size is shrunk from the args generated at that size
+    stringstream err;
+    EXPECT_FALSE(property([](vector<int> v) { return v.size() < 30; })
+                     .setNumRuns(100)
+                     .setGrowSize(true)
+                     .setOutputStream(out)
+                     .setErrorStream(err)
+                     .forAll());
+    EXPECT_NE(err.str().find("Falsifiable"), string::npos) << err.str();
+}
+
+TEST(Property, discardsAreCountedAndReported)
+{
+    stringstream out, err;
+    EXPECT_TRUE(property([](int x) {
+                    if (x % 2 == 0)
+                        PROP_DISCARD();
+                    return true;
+                })
+                    .setSeed(1)
+                    .setNumRuns(100)
+                    .setOutputStream(out)
+                    .setErrorStream(err)
+                    .forAll(gen::interval(0, 1000)));
+    EXPECT_NE(out.str().find("OK, passed 100 tests"), string::npos) << out.str();
+    EXPECT_NE(out.str().find("  discarded: "), string::npos) << out.str();
+    EXPECT_EQ(err.str().find("Warning"), string::npos) << err.str();
+
+    // filter draws are reported by argument, with a warning below the min acceptance rate
+    stringstream out2, err2;
+    EXPECT_TRUE(property([](int, int) { return true; })
+                    .setSeed(1)
+                    .setNumRuns(100)
+                    .setMinAcceptanceRate(0.5)
+                    .setOutputStream(out2)
+                    .setErrorStream(err2)
+                    .forAll(gen::interval(0, 1000), gen::interval(0, 1000).filter([](int n) { return n % 4 == 0; })));
+    EXPECT_NE(out2.str().find("  filter of arg 1: accepted 100 of "), string::npos) << out2.str();
+    EXPECT_EQ(out2.str().find("filter of arg 0"), string::npos) << out2.str();
+    EXPECT_NE(err2.str().find("Warning: filter of arg 1"), string::npos) << err2.str();
+}
+
+TEST(Property, givesUpAfterTooManyDiscards)
+{
+    // a filter that accepts nothing discards every run after maxFilterAttempts draws
+    stringstream out, err;
+    EXPECT_FALSE(property([](int) { return true; })
+                     .setSeed(1)
+                     .setNumRuns(10)
+                     .setMaxFilterAttempts(100)
+                     .setMaxDiscardRatio(2)
+                     .setOutputStream(out)
+                     .setErrorStream(err)
+                     .forAll(gen::int32().filter([](int) { return false; })));
+    EXPECT_NE(err.str().find("Gave up after 0 tests: 21 runs discarded"), string::npos) << err.str();
+    EXPECT_NE(out.str().find("filter of arg 0: accepted 0 of 2100 draws"), string::npos) << out.str();
+    EXPECT_NE(err.str().find("Warning: filter of arg 0"), string::npos) << err.str();
+
+    // PROP_DISCARD is limited the same way, also across worker threads
+    stringstream out2, err2;
+    EXPECT_FALSE(property([](int) { PROP_DISCARD(); })
+                     .setNumRuns(10)
+                     .setMaxDiscardRatio(3)
+                     .setNumThreads(2)
+                     .setOutputStream(out2)
+                     .setErrorStream(err2)
+                     .forAll());
+    EXPECT_NE(err2.str().find("Gave up after 0 tests"), string::npos) << err2.str();
+
+    // a discard in a oneOf/unionOf branch is not retried but counted
+    stringstream out3, err3;
+    auto never = [](const int&) { return false; };
+    EXPECT_FALSE(property([](int) { return true; })
+                     .setNumRuns(10)
+                     .setMaxFilterAttempts(10)
+                     .setMaxDiscardRatio(2)
+                     .setOutputStream(out3)
+                     .setErrorStream(err3)
+                     .forAll(gen::unionOf<int>(gen::int32().filter(never), gen::interval(0, 10).filter(never))));
+    EXPECT_NE(err3.str().find("Gave up after 0 tests: 21 runs discarded"), string::npos) << err3.str();
+
+    // 0 means no limit
+    int numCalls = 0;
+    EXPECT_TRUE(property([&numCalls](int) {
+                    if (numCalls++ < 50)
+                        PROP_DISCARD();
+                })
+                    .setNumRuns(2)
+                    .setMaxDiscardRatio(0)
+                    .setOutputStream(out2)
+                    .setErrorStream(err2)
+                    .forAll());
+}
+
+TEST(Property, numThreadsShrinksFailure)
+{
+    stringstream out;
+    const bool ok = forAll([](int x) {
+        PROP_ASSERT(x < 50);
+        return true;
+    }, {.numThreads = 4, .outputStream = &out, .errorStream = &out}, gen::interval(0, 1000));
+    EXPECT_FALSE(ok);
+    EXPECT_NE(out.str().find("simplest args found by shrinking: { 50 }"), string::npos) << out.str();
+}
+
+TEST(Property, numThreadsReportsSameFailureForSeed)
+{
+    // failures are spread over all workers; the one with the lowest run index is reported
+    auto run = []() {
+        stringstream out;
+        EXPECT_FALSE(forAll([](int x, int y) {
+            PROP_ASSERT(x % 7 != 0 || y < 500);
+            return true;
+        }, {.seed = 42, .numThreads = 4, .outputStream = &out, .errorStream = &out},
+           gen::interval(0, 1000), gen::interval(0, 1000)));
+        return out.str();
+    };
+    const string first = run();
+    EXPECT_NE(first.find("Falsifiable, after "), string::npos) << first;
+    for (int i = 0; i < 10; i++)
+        EXPECT_EQ(run(), first);
+}
+
+TEST(Property, shrinkNumThreadsMatchesSequentialShrink)
+{
+    auto prop = [](int x, vector<int> v) {
+        PROP_ASSERT(x < 300 || v.size() < 3);
+        return true;
+    };
+    auto vecGen = gen::vector<int>(gen::interval(0, 100));
+    stringstream sequential, parallel;
+    EXPECT_FALSE(forAll(prop, {.seed = 7, .outputStream = &sequential, .errorStream = &sequential},
+                        gen::interval(0, 1000), vecGen));
+    EXPECT_FALSE(forAll(prop, {.seed = 7, .shrinkNumThreads = 3, .outputStream = &parallel, .errorStream = &parallel},
+                        gen::interval(0, 1000), vecGen));
+    EXPECT_NE(sequential.str().find("simplest args found by shrinking: { 300,"), string::npos) << sequential.str();
+    EXPECT_EQ(sequential.str(), parallel.str());
+}
+
+TEST(Property, randomEngineReplaysSameRun)
+{
+    auto prop = [](int x, vector<int> v) {
+        PROP_ASSERT(x < 300 || v.size() < 3);
+        return true;
+    };
+    auto vecGen = gen::vector<int>(gen::interval(0, 100));
+    stringstream first, second;
+    EXPECT_FALSE(forAll(prop, {.seed = 7, .randomEngine = RandomEngine::XOSHIRO256SS, .outputStream = &first,
+                               .errorStream = &first}, gen::interval(0, 1000), vecGen));
+    EXPECT_FALSE(forAll(prop, {.seed = 7, .randomEngine = RandomEngine::XOSHIRO256SS, .outputStream = &second,
+                               .errorStream = &second}, gen::interval(0, 1000), vecGen));
+    EXPECT_NE(first.str().find("random seed: 7 (xoshiro256ss)"), string::npos) << first.str();
+    EXPECT_NE(first.str().find("simplest args found by shrinking: { 300,"), string::npos) << first.str();
+    EXPECT_EQ(first.str(), second.str());
+}
+
+TEST(Property, shrinkCacheSkipsPassedCandidates)
+{
+    int numCalls = 0;
+    auto prop = [&numCalls](vector<int> v) {
+        numCalls++;
+        PROP_ASSERT(v.size() < 4);
+        return true;
+    };
+    // few distinct elements, so that removing different elements often yields the same vector
+    auto vecGen = gen::vector<int>({.elemGen = gen::interval(0, 3), .minSize = 0, .maxSize = 10});
+    stringstream uncached, cached;
+    EXPECT_FALSE(forAll(prop, {.seed = 7, .outputStream = &uncached, .errorStream = &uncached}, vecGen));
+    int numUncachedCalls = numCalls;
+    numCalls = 0;
+    EXPECT_FALSE(forAll(prop, {.seed = 7, .shrinkCache = true, .outputStream = &cached, .errorStream = &cached},
+                        vecGen));
+
+    EXPECT_NE(cached.str().find("shrink cache skipped"), string::npos) << cached.str();
+    EXPECT_LT(numCalls, numUncachedCalls);
+    auto simplest = [](const string& out) { return out.substr(out.find("simplest args found by shrinking")); };
+    EXPECT_EQ(simplest(uncached.str()), simplest(cached.str()));
+}
+
+TEST(Property, setShrinkCacheHash)
+{
+    int numHashCalls = 0;
+    auto prop = property([](int x, string s) {
+        PROP_ASSERT(x < 100 || s.size() < 2);
+        return true;
+    }, gen::interval(0, 1000), gen::string());
+    stringstream out;
+    prop.setShrinkCacheHash([&numHashCalls](const int& x, const string& s) -> size_t {
+        numHashCalls++;
+        return hash<int>{}(x) * 31 + hash<string>{}(s);
+    });
+    EXPECT_FALSE(prop.setSeed(3).setOutputStream(out).setErrorStream(out).forAll());
+    EXPECT_GT(numHashCalls, 0);
+    EXPECT_NE(out.str().find("simplest args found by shrinking: { 100,"), string::npos) << out.str();
+}
+
+TEST(Property, concurrentPropertiesUseSeparateContexts)
+{
+    stringstream outA, outB;
+    bool okA = false, okB = true;
+    thread a([&]() {
+        okA = forAll([](int x) {
+            PROP_STAT(x % 2 == 0);
+            PROP_EXPECT(x == x);
+        }, {.outputStream = &outA, .errorStream = &outA});
+    });
+    thread b([&]() {
+        okB = forAll([](int x) {
+            PROP_TAG("side", "b");
+            PROP_EXPECT(x < 0) << "from b";
+        }, {.outputStream = &outB, .errorStream = &outB}, gen::interval(0, 100));
+    });
+    a.join();
+    b.join();
+
+    EXPECT_TRUE(okA);
+    EXPECT_FALSE(okB);
+    EXPECT_EQ(outA.str().find("from b"), string::npos);
+    EXPECT_EQ(outA.str().find("side"), string::npos);
+    EXPECT_NE(outB.str().find("from b"), string::npos);
+    EXPECT_EQ(PropertyContext::current(), nullptr);
+}
+
+TEST(Property, contextBindingRoutesSpawnedThreads)
+{
+    stringstream out;
+    const bool ok = forAll([](int x) {
+        PropertyContext* ctx = PropertyContext::current();
+        thread t([ctx, x]() {
+            PropertyContextBinding binding(ctx);
+            PROP_TAG("spawned", true);
+            PROP_EXPECT(x < 50) << "in spawned thread";
+        });
+        t.join();
+    }, {.outputStream = &out, .errorStream = &out}, gen::interval(0, 100));
+
+    EXPECT_FALSE(ok);
+    EXPECT_NE(out.str().find("in spawned thread"), string::npos) << out.str();
+    EXPECT_NE(out.str().find("simplest args found by shrinking: { 50 }"), string::npos) << out.str();
+}
+
 TEST(Property, TestStringCheckFail)
 {
     // Property designed to fail when a.size() >= 5
@@ -1,5 +1,7 @@
 #include "proptest/Random.hpp"
 #include "proptest/test/gtest.hpp"
+#include "proptest/std/set.hpp"
+#include "proptest/std/vector.hpp"
 
 using namespace proptest;
 
@@ -36,3 +38,130 @@ TEST(Random, bool)
 }
 
 // TODO: how many tries need to be done to get all values in a range?
+
+TEST(Random, xoshiro_reference_values)
+{
+    // xoshiro256** seeded with splitmix64(42), as in the reference implementation
+    util::Xoshiro256ss engine(42);
+    EXPECT_EQ(engine(), 0x15780b2e0c2ec716ULL);
+    EXPECT_EQ(engine(), 0x6104d9866d113a7eULL);
+    EXPECT_EQ(engine(), 0xae17533239e499a1ULL);
+
+    Random rand(42, RandomEngine::XOSHIRO256SS);
+    EXPECT_EQ(rand.getEngineType(), RandomEngine::XOSHIRO256SS);
+    EXPECT_EQ(rand.getRandomUInt64(), 0x15780b2e0c2ec716ULL);
+}
+
+TEST(Random, engine_is_deterministic)
+{
+    for (auto engineType : {RandomEngine::MT19937_64, RandomEngine::XOSHIRO256SS}) {
+        int64_t seed = getCurrentTime();
+        Random rand(seed, engineType);
+        Random rand2(seed, engineType);
+        for (int i = 0; i < 10; i++) {
+            EXPECT_EQ(rand.getRandomInt8(), rand2.getRandomInt8());
+            EXPECT_EQ(rand.getRandomUInt32(5, 1000), rand2.getRandomUInt32(5, 1000));
+            EXPECT_EQ(rand.getRandomInt64(-7, 7), rand2.getRandomInt64(-7, 7));
+            EXPECT_EQ(rand.getRandomDouble(), rand2.getRandomDouble());
+            EXPECT_EQ(rand.getRandomBool(), rand2.getRandomBool());
+        }
+
+        // a copy continues the same sequence
+        Random copy(rand);
+        for (int i = 0; i < 10; i++)
+            EXPECT_EQ(rand.getRandomUInt64(), copy.getRandomUInt64());
+    }
+
+    Random mt(1), xoshiro(1, RandomEngine::XOSHIRO256SS);
+    EXPECT_EQ(mt.getEngineType(), RandomEngine::MT19937_64);
+    EXPECT_NE(mt.getRandomUInt64(), xoshiro.getRandomUInt64());
+}
+
+TEST(Random, xoshiro_bounded_draws_cover_range)
+{
+    Random rand(getCurrentTime(), RandomEngine::XOSHIRO256SS);
+    set<int64_t> seen;
+    for (int i = 0; i < 1000; i++) {
+        auto value = rand.getRandomInt64(-3, 3);
+        EXPECT_GE(value, -3);
+        EXPECT_LE(value, 3);
+        seen.insert(value);
+    }
+    EXPECT_EQ(seen.size(), 7U);
+
+    for (int i = 0; i < 1000; i++) {
+        auto i8 = rand.getRandomInt8(-100, -98);
+        EXPECT_GE(i8, -100);
+        EXPECT_LE(i8, -98);
+        auto u16 = rand.getRandomUInt16(65530, 65535);
+        EXPECT_GE(u16, 65530);
+        auto i32 = rand.getRandomInt32(INT32_MIN, INT32_MIN + 1);
+        EXPECT_LE(i32, INT32_MIN + 1);
+        EXPECT_EQ(rand.getRandomUInt32(7, 7), 7U);
+        auto u64 = rand.getRandomUInt64(UINT64_MAX - 1, UINT64_MAX);
+        EXPECT_GE(u64, UINT64_MAX - 1);
+        auto size = rand.getRandomSize(3, 5);
+        EXPECT_GE(size, 3U);
+        EXPECT_LT(size, 5U);
+    }
+}
+
+TEST(Random, fillUInt64)
+{
+    for (auto engineType : {RandomEngine::MT19937_64, RandomEngine::XOSHIRO256SS}) {
+        Random rand(7, engineType);
+        Random rand2(7, engineType);
+        uint64_t buffer[16];
+        rand.fillUInt64(buffer);
+        for (auto word : buffer)
+            EXPECT_EQ(word, rand2.getRandomUInt64());
+        EXPECT_EQ(rand.getRandomUInt64(), rand2.getRandomUInt64());
+    }
+}
+
+TEST(Random, container_size_follows_size_factor)
+{
+    Random rand(getCurrentTime());
+    Random rand2(rand);
+    // full size draws the same values as getRandomSize
+    for (int i = 0; i < 100; i++)
+        EXPECT_EQ(rand.getRandomContainerSize(3, 200), rand2.getRandomSize(3, 201));
+
+    rand.setSizeFactor(0.0);
+    for (int i = 0; i < 100; i++)
+        EXPECT_EQ(rand.getRandomContainerSize(3, 200), 3U);
+
+    rand.setSizeFactor(0.1);
+    for (int i = 0; i < 100; i++) {
+        auto size = rand.getRandomContainerSize(3, 203);
+        EXPECT_GE(size, 3U);
+        EXPECT_LE(size, 23U);
+    }
+
+    // the factor is copied along with the engine state
+    Random copy(rand);
+    EXPECT_DOUBLE_EQ(copy.getSizeFactor(), 0.1);
+    rand.setSizeFactor(2.0);
+    EXPECT_DOUBLE_EQ(rand.getSizeFactor(), 1.0);
+}
+
+TEST(Random, fillUInt32)
+{
+    for (auto engineType : {RandomEngine::MT19937_64, RandomEngine::XOSHIRO256SS}) {
+        Random rand(getCurrentTime(), engineType);
+        Random rand2(rand);
+        vector<uint32_t> values(1000), values2(1000);
+        rand.fillUInt32(values, 3, 9);
+        rand2.fillUInt32(values2, 3, 9);
+        EXPECT_EQ(values, values2);
+        set<uint32_t> seen(values.begin(), values.end());
+        EXPECT_EQ(seen.size(), 7U);
+        EXPECT_EQ(*seen.begin(), 3U);
+        EXPECT_EQ(*seen.rbegin(), 9U);
+
+        // full range
+        rand.fillUInt32(values, 0, UINT32_MAX);
+        seen = set<uint32_t>(values.begin(), values.end());
+        EXPECT_GT(seen.size(), 990U);
+    }
+}
@@ -229,3 +229,18 @@ TEST(Shrinkable, map_exhaustive2)
     Shrinkable<string> shr3 = shr.map<string>([](const int64_t& val) -> string { return to_string(val); });
     EXPECT_EQ(serializeShrinkable(shr3), "{value: \"8\" (38), shrinks: [{value: \"0\" (30)}, {value: \"4\" (34), shrinks: [{value: \"2\" (32), shrinks: [{value: \"1\" (31)}]}, {value: \"3\" (33)}]}, {value: \"6\" (36), shrinks: [{value: \"5\" (35)}]}, {value: \"7\" (37)}]}");
 }
+
+TEST(Shrinkable, binary_search_with_offset)
+{
+    // same tree as mapping binarySearchShrinkable with x + offset
+    Shrinkable<int> shr = util::binarySearchShrinkableWithOffset<int>(8, 5);
+    EXPECT_EQ(serializeShrinkable(shr), "{value: 13, shrinks: [{value: 5}, {value: 9, shrinks: [{value: 7, shrinks: [{value: 6}]}, {value: 8}]}, {value: 11, shrinks: [{value: 10}]}, {value: 12}]}");
+
+    Shrinkable<int8_t> shr2 = util::binarySearchShrinkableWithOffset<int8_t>(-4, -1);
+    Shrinkable<int8_t> mapped = util::binarySearchShrinkable(-4).map<int8_t>([](const int64_t& val) { return static_cast<int8_t>(val - 1); });
+    EXPECT_EQ(serializeShrinkable(shr2), serializeShrinkable(mapped));
+
+    Shrinkable<uint16_t> shr3 = util::binarySearchShrinkableWithOffset<uint16_t>(10, 100);
+    Shrinkable<uint16_t> mapped3 = util::binarySearchShrinkableU(10).map<uint16_t>([](const uint64_t& val) { return static_cast<uint16_t>(val + 100); });
+    EXPECT_EQ(serializeShrinkable(shr3), serializeShrinkable(mapped3));
+}
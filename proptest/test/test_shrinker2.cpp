@@ -166,6 +166,64 @@ TEST(ListLikeShrinker, specific_case_minSize2_unique_values)
     EXPECT_FALSE(serialized.empty());
 }
 
+// values of the first numNodes nodes of a shrink tree in depth-first order, for trees too large to traverse
+template <typename T>
+void serializeTreePrefix(const Shrinkable<T>& shr, size_t& numNodes, stringstream& out)
+{
+    if (numNodes == 0)
+        return;
+    numNodes--;
+    out << Show<T>(shr.getRef()) << " ";
+    for (auto itr = shr.getShrinks().template iterator<ShrinkableBase>(); itr.hasNext() && numNodes > 0;) {
+        Shrinkable<T> child = itr.next();
+        serializeTreePrefix<T>(child, numNodes, out);
+    }
+}
+
+template <typename T>
+void checkCompactVectorShrinker(const vector<T>& values, size_t minSize, size_t numNodes)
+{
+    Shrinkable<vector<ShrinkableBase>> baseShr = make_shrinkable<vector<ShrinkableBase>>();
+    for (const T& value : values)
+        baseShr.getMutableRef().push_back(ShrinkableBase(shrinkIntegral<T>(value)));
+
+    Shrinkable<vector<T>> listLikeShr = shrinkListLike<vector, T>(baseShr, minSize);
+    Shrinkable<vector<T>> compactShr = shrinkCompactVector<T>(make_shrinkable<vector<T>>(values), minSize);
+    stringstream listLikeOut, compactOut;
+    size_t listLikeNodes = numNodes, compactNodes = numNodes;
+    serializeTreePrefix<vector<T>>(listLikeShr, listLikeNodes, listLikeOut);
+    serializeTreePrefix<vector<T>>(compactShr, compactNodes, compactOut);
+    EXPECT_EQ(compactOut.str(), listLikeOut.str());
+    EXPECT_EQ(compactNodes, listLikeNodes);
+}
+
+// compact shrinking must produce the same tree as shrinkListLike() over per-element shrinkables
+TEST(CompactVectorShrinker, sameTreeAsListLike)
+{
+    Shrinkable<vector<int>> shr = shrinkCompactVector<int>(make_shrinkable<vector<int>>(vector<int>{1, 2, 3}), 0);
+    EXPECT_EQ(serializeShrinkable(shr), "{value: [ 1, 2, 3 ], shrinks: [{value: [  ]}, {value: [ 1 ], shrinks: [{value: [ 0 ]}]}, {value: [ 1, 2 ], shrinks: [{value: [ 2 ], shrinks: [{value: [ 0 ]}, {value: [ 1 ]}]}]}, {value: [ 3 ], shrinks: [{value: [ 0 ]}, {value: [ 1 ]}, {value: [ 2 ]}]}, {value: [ 1, 3 ], shrinks: [{value: [ 0, 0 ]}, {value: [ 1, 1 ], shrinks: [{value: [ 0, 1 ]}]}, {value: [ 1, 2 ], shrinks: [{value: [ 0, 2 ]}]}]}, {value: [ 2, 3 ], shrinks: [{value: [ 0, 0 ]}, {value: [ 1, 1 ]}, {value: [ 2, 2 ], shrinks: [{value: [ 0, 2 ]}, {value: [ 1, 2 ]}]}]}]}");
+
+    checkCompactVectorShrinker<int>({}, 0, 100);
+    checkCompactVectorShrinker<int>({4, 1, 2, 3}, 2, 100000);
+    checkCompactVectorShrinker<int>({-7, 0, 5, -1}, 0, 100000);
+    checkCompactVectorShrinker<int8_t>({-128, 127, 3}, 1, 5000);
+    checkCompactVectorShrinker<uint8_t>({255, 0, 9}, 0, 5000);
+    checkCompactVectorShrinker<int64_t>({numeric_limits<int64_t>::min(), 13}, 0, 5000);
+    checkCompactVectorShrinker<uint64_t>({numeric_limits<uint64_t>::max(), 6}, 1, 5000);
+}
+
+TEST(CompactVectorShrinker, largeVector)
+{
+    stringstream out;
+    // elements > 100 are never removed, only shrunk element-wise towards 101
+    auto prop = property([](vector<int> v) {
+        for (auto x : v)
+            PROP_ASSERT(x <= 100);
+    });
+    EXPECT_FALSE(prop.setSeed(1).setOutputStream(out).setErrorStream(out).forAll(Arbi<vector<int>>(10000, 10000)));
+    EXPECT_NE(out.str().find("simplest args found by shrinking"), string::npos);
+}
+
 TEST(SetShrinker, ints)
 {
     auto baseShr = util::make_shared<set<Shrinkable<int>>,initializer_list<Shrinkable<int>>>({
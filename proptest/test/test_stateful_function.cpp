@@ -1,6 +1,8 @@
 #include "proptest/stateful/stateful_function.hpp"
 #include "proptest/test/testutil.hpp"
 #include "proptest/gen.hpp"
+#include "proptest/std/chrono.hpp"
+#include "proptest/std/thread.hpp"
 
 using namespace proptest;
 using namespace proptest::stateful;
@@ -166,6 +168,79 @@ TEST(stateful_function, action_list_size_configuration)
     EXPECT_TRUE(ok);
 }
 
+namespace {
+
+/// counts how many times it has been printed
+struct PrintCounted
+{
+    int value;
+    static int numPrinted;
+
+    friend ostream& operator<<(ostream& os, const PrintCounted& obj)
+    {
+        ++numPrinted;
+        return os << obj.value;
+    }
+};
+
+int PrintCounted::numPrinted = 0;
+
+}  // namespace
+
+TEST(stateful_function, action_names_formatted_only_when_printed)
+{
+    auto addGen = gen::interval(0, 10).map<SimpleAction<int>>([](const int& n) {
+        return SimpleAction<int>(PROP_ACTION_NAME("Add", PrintCounted{n}, "x"), [n](int& v) { v += n; });
+    });
+
+    PrintCounted::numPrinted = 0;
+    stringstream out;
+    bool ok = statefulProperty<int>(gen::just(0), addGen)
+                  .setSeed(0)
+                  .setNumRuns(50)
+                  .setMaxConcurrency(2)
+                  .setOutputStreams(out, out)
+                  .go();
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(PrintCounted::numPrinted, 0);
+
+    ok = statefulProperty<int>(gen::just(0), addGen)
+             .setSeed(0)
+             .setNumRuns(50)
+             .setActionListMinSize(1)
+             .setPostCheck([](int& v) { PROP_ASSERT(v < 10); })
+             .setOutputStreams(out, out)
+             .go();
+    EXPECT_FALSE(ok);
+    EXPECT_GT(PrintCounted::numPrinted, 0);
+    EXPECT_NE(out.str().find(",x)"), string::npos) << out.str();
+
+    auto name = PROP_ACTION_NAME("Add", 1, string("y"));
+    EXPECT_EQ(name.str(), "Add(1,y)");
+    EXPECT_EQ(ActionName("Clear").str(), "Clear");
+    EXPECT_EQ(ActionName().str(), "");
+
+    // names that may change before they are printed are copied
+    char buf[16] = "Push";
+    ActionName copied(buf);
+    auto copiedWithArgs = PROP_ACTION_NAME(buf, 2);
+    const char* ptr = buf;
+    ActionName copiedPtr(ptr);
+    // and so are text arguments
+    char key[16] = "k1";
+    auto copiedArgs = PROP_ACTION_NAME("Put", key, static_cast<const char*>(key));
+    unique_ptr<string> temp = util::make_unique<string>("k2");
+    auto copiedCStr = PROP_ACTION_NAME("Put", temp->c_str());
+    buf[0] = 'B';
+    key[1] = '9';
+    temp.reset();
+    EXPECT_EQ(copied.str(), "Push");
+    EXPECT_EQ(copiedWithArgs.str(), "Push(2)");
+    EXPECT_EQ(copiedPtr.str(), "Push");
+    EXPECT_EQ(copiedArgs.str(), "Put(k1,k1)");
+    EXPECT_EQ(copiedCStr.str(), "Put(k2)");
+}
+
 TEST(stateful_function, state_dependent_simple_action_factory)
 {
     using T = vector<int>;
@@ -625,6 +700,57 @@ TEST(stateful_function, prefix_params_effectiveness)
         << "Shrunken sequence should still contain Scale actions\n" << simplestLine;
 }
 
+/**
+ * PrefixParams with checkpoints: the prefix states of a shrink node are kept and reused instead of
+ * replaying each prefix from the initial state, so shrinking reaches the same counterexample with
+ * fewer action executions.
+ */
+TEST(stateful_function, prefix_checkpoints_same_result_fewer_executions)
+{
+    constexpr int FAIL_THRESHOLD = 50;
+    static int numExecuted = 0;
+
+    auto addGen = gen::interval(0, 10).map<SimpleAction<int>>([](const int& n) {
+        return SimpleAction<int>(PROP_ACTION_NAME("Add", n), [n](int& v) {
+            ++numExecuted;
+            v += n;
+        });
+    });
+
+    int numClones = 0;
+    auto run = [&](int mode) {
+        auto prop = statefulProperty<int>(gen::just(0), [addGen](int&) -> SimpleActionGen<int> { return addGen; });
+        if (mode == 1)
+            prop.setPrefixCheckpoints(true);
+        else if (mode == 2)
+            prop.setStateClone([&numClones](const int& v) {
+                ++numClones;
+                return v;
+            });
+        stringstream out;
+        numExecuted = 0;
+        bool ok = prop.setSeed(1)
+                      .setNumRuns(100)
+                      .setActionListSize(20)
+                      .setPostCheck([](int& v) { PROP_ASSERT(v < FAIL_THRESHOLD); })
+                      .setOutputStreams(out, out)
+                      .go();
+        EXPECT_FALSE(ok);
+        return make_pair(lineContaining(out.str(), "simplest args found by shrinking"), numExecuted);
+    };
+
+    const auto [replayedLine, numReplayed] = run(0);
+    const auto [checkpointedLine, numCheckpointed] = run(1);
+    const auto [clonedLine, numCloned] = run(2);
+
+    ASSERT_FALSE(replayedLine.empty());
+    EXPECT_EQ(checkpointedLine, replayedLine);
+    EXPECT_EQ(clonedLine, replayedLine);
+    EXPECT_LT(numCheckpointed, numReplayed);
+    EXPECT_EQ(numCloned, numCheckpointed);
+    EXPECT_GT(numClones, 0);
+}
+
 // ── Non-copyable ObjectType: shared_ptr workaround and its shrinker limitation ──
 //
 // Problem: statefulProperty requires ObjectType to be copy-constructible at three
@@ -812,3 +938,178 @@ TEST(stateful_function, non_copyable_reported_counterexamples_replay_from_clean_
     }
     EXPECT_GT(subdomainsWithAcceptedShrinks, 0U);
 }
+
+/**
+ * setStateClone: with a deep clone, shared_ptr ObjectTypes get prefix checkpoints that do not alias the
+ * replayed object, and shrinking ends at the only minimal counterexample [Add(3), Add(3)].
+ */
+TEST(stateful_function, non_copyable_shared_ptr_prefix_checkpoints_with_clone)
+{
+    auto addGen = makeNonCopyableAddGen();
+    auto prop = statefulProperty<CounterPtr>(
+        gen::lazy<CounterPtr>([] { return util::make_shared<NonCopyableCounter>(0); }),
+        addGen);
+
+    stringstream out;
+    bool ok = prop.setSeed(0)
+                  .setNumRuns(200)
+                  .setActionListMinSize(2)
+                  .setActionListMaxSize(4)
+                  .setStateClone([](const CounterPtr& ptr) { return util::make_shared<NonCopyableCounter>(ptr->value); })
+                  .setPostCheck([](CounterPtr& ptr) { PROP_ASSERT(ptr->value <= NON_COPYABLE_THRESHOLD); })
+                  .setOutputStreams(out, out)
+                  .go();
+
+    EXPECT_FALSE(ok);
+    const string simplestLine = lineContaining(out.str(), "simplest args found by shrinking");
+    ASSERT_FALSE(simplestLine.empty()) << out.str();
+    EXPECT_EQ(allAddParams(simplestLine), vector<int>({3, 3})) << simplestLine;
+}
+
+/**
+ * setStateClone(objClone, modelClone): a model whose copies share state (here a shared_ptr) is cloned for the prefix
+ * checkpoints too, so every regenerated action sees a model that matches its object, and shrinking ends where it does
+ * without checkpoints. Copying the model instead, as setPrefixCheckpoints(true) does, lets later replays change it.
+ */
+TEST(stateful_function, prefix_checkpoints_clone_shared_model)
+{
+    using ModelAction = Action<int, CounterPtr>;
+    auto run = [](int mode, stringstream& out, int& numMismatches) {
+        auto prop = statefulProperty<int, CounterPtr>(
+            gen::just(0), [](const int& obj) { return util::make_shared<NonCopyableCounter>(obj); },
+            [&numMismatches](int& obj, CounterPtr& model) -> ActionGen<int, CounterPtr> {
+                // the model tracks the object, unless a checkpoint shares it with a later state
+                if (model->value != obj)
+                    numMismatches++;
+                const int maxN = model->value < 6 ? 3 : 2;
+                return gen::interval(1, maxN).map<ModelAction>([](const int& n) {
+                    return ModelAction(PROP_ACTION_NAME("Add", n), [n](int& obj, CounterPtr& mdl) {
+                        obj += n;
+                        mdl->value += n;
+                    });
+                });
+            });
+        prop.setSeed(1)
+            .setNumRuns(200)
+            .setActionListMinSize(2)
+            .setActionListMaxSize(10)
+            .setPostCheck([](int& obj, CounterPtr&) { PROP_ASSERT(obj <= 12); })
+            .setOutputStreams(out, out);
+        if (mode == 1)
+            prop.setStateClone([](const int& obj) { return obj; },
+                               [](const CounterPtr& model) { return util::make_shared<NonCopyableCounter>(model->value); });
+        if (mode == 2)
+            prop.setPrefixCheckpoints(true);
+        return prop.go();
+    };
+    stringstream plain, cloned, aliased;
+    int plainMismatches = 0, clonedMismatches = 0, aliasedMismatches = 0;
+    EXPECT_FALSE(run(0, plain, plainMismatches));
+    EXPECT_FALSE(run(1, cloned, clonedMismatches));
+    EXPECT_FALSE(run(2, aliased, aliasedMismatches));
+    EXPECT_EQ(plainMismatches, 0);
+    EXPECT_EQ(clonedMismatches, 0);
+    EXPECT_GT(aliasedMismatches, 0);
+    const string simplestLine = lineContaining(plain.str(), "simplest args found by shrinking");
+    ASSERT_FALSE(simplestLine.empty()) << plain.str();
+    EXPECT_EQ(lineContaining(cloned.str(), "simplest args found by shrinking"), simplestLine)
+        << "plain:\n" << plain.str() << "\ncloned:\n" << cloned.str();
+}
+
+/**
+ * The stateful shrink cache is off unless candidates are identified by a hash of their action lists; with a hash that
+ * covers the parameters, it reaches the same counterexample as shrinking without the cache.
+ */
+TEST(stateful_function, shrink_cache_with_hash)
+{
+    using ActionList = list<Action<int, EmptyModel>>;
+    auto addGen = gen::interval(0, 20).map<SimpleAction<int>>([](const int& n) {
+        return SimpleAction<int>(PROP_ACTION_NAME("Add", n), [n](int& v) { v += n; });
+    });
+    auto plainAddGen = gen::interval(0, 20).map<SimpleAction<int>>([](const int& n) {
+        return SimpleAction<int>("Add", [n](int& v) { v += n; });
+    });
+    auto run = [](auto actionGen, Function<size_t(const vector<ActionList>&)> hashFunc, stringstream& out) {
+        auto prop = statefulProperty<int>(gen::just(0), actionGen);
+        prop.setSeed(3)
+            .setNumRuns(50)
+            .setActionListMaxSize(5)
+            .setPostCheck([](int& v) { PROP_ASSERT(v < 30); })
+            .setOutputStreams(out, out);
+        if (hashFunc)
+            prop.setShrinkCacheHash(hashFunc);
+        return prop.go();
+    };
+
+    // names without the parameter print alike, but without a hash every candidate is still tested
+    stringstream uncached, plain;
+    EXPECT_FALSE(run(addGen, {}, uncached));
+    EXPECT_FALSE(run(plainAddGen, {}, plain));
+    EXPECT_EQ(plain.str().find("shrink cache skipped"), string::npos) << plain.str();
+
+    int numHashCalls = 0;
+    stringstream hashed;
+    EXPECT_FALSE(run(addGen, [&numHashCalls](const vector<ActionList>& lists) {
+        numHashCalls++;
+        size_t h = 0;
+        for (const auto& actions : lists)
+            for (const auto& action : actions)
+                h = h * 31 + hash<string>{}(action.name.str());
+        return h;
+    }, hashed));
+    EXPECT_GT(numHashCalls, 0);
+    EXPECT_EQ(lineContaining(uncached.str(), "simplest args found by shrinking"),
+              lineContaining(hashed.str(), "simplest args found by shrinking"))
+        << "uncached:\n" << uncached.str() << "\nhashed:\n" << hashed.str();
+}
+
+/**
+ * Runs discarded by a filtered action generator are limited by the max discard ratio, as in forAll.
+ */
+TEST(stateful_function, gives_up_after_too_many_discards)
+{
+    auto neverGen = gen::just(SimpleAction<int>("Inc", [](int& v) { v++; }))
+                        .filter([](const SimpleAction<int>&) { return false; });
+    stringstream out;
+    EXPECT_FALSE(statefulProperty<int>(gen::just(0), neverGen)
+                     .setNumRuns(10)
+                     .setActionListMinSize(1)
+                     .setMaxDiscardRatio(2)
+                     .setOutputStreams(out, out)
+                     .go());
+    EXPECT_NE(out.str().find("Gave up after 0 tests: 21 runs discarded"), string::npos) << out.str();
+}
+
+/**
+ * Stateful properties take their share of the global time budget and charge their time to it, like forAll
+ * properties, and can have a budget of their own.
+ */
+TEST(stateful_function, time_budget_shared_with_global_budget)
+{
+    auto incGen = gen::just(SimpleAction<int>("Inc", [](int& v) { v++; }));
+
+    util::TimeBudget& budget = util::TimeBudget::global();
+    budget.set(60000, 2);
+    stringstream out;
+    EXPECT_TRUE(statefulProperty<int>(gen::just(0), incGen).setNumRuns(20).setOutputStreams(out, out).go());
+    EXPECT_NE(out.str().find("Planned 20 runs for a time budget of 30000ms"), string::npos) << out.str();
+    // one property left, which takes all the remaining time
+    EXPECT_EQ(budget.nextShareMs(), budget.getRemainingMs());
+    budget.clear();
+
+    auto slowGen = gen::just(SimpleAction<int>("Slow", [](int&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }));
+    int numRuns = 0;
+    stringstream slowOut;
+    EXPECT_TRUE(statefulProperty<int>(gen::just(0), slowGen)
+                    .setNumRuns(1000)
+                    .setActionListSize(2)
+                    .setTimeBudgetMs(100)
+                    .setOnStartup([&numRuns]() { numRuns++; })
+                    .setOutputStreams(slowOut, slowOut)
+                    .go());
+    EXPECT_GE(numRuns, static_cast<int>(util::kBudgetCalibrationRuns));
+    EXPECT_LT(numRuns, 1000);
+    EXPECT_NE(slowOut.str().find("Planned "), string::npos) << slowOut.str();
+}
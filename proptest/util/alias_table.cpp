@@ -0,0 +1,57 @@
+#include "proptest/util/alias_table.hpp"
+#include "proptest/Random.hpp"
+#include "proptest/std/exception.hpp"
+#include "proptest/std/string.hpp"
+
+namespace proptest {
+namespace util {
+
+AliasTable::AliasTable(const vector<double>& weights) : probs(weights.size(), 1.0), aliases(weights.size())
+{
+    const size_t n = weights.size();
+    double sum = 0.0;
+    for (double weight : weights) {
+        if (weight < 0.0)
+            throw runtime_error(__FILE__, __LINE__, "invalid weight: " + to_string(weight));
+        sum += weight;
+    }
+    if (n == 0 || !(sum > 0.0))
+        throw runtime_error(__FILE__, __LINE__, "weights must have a positive sum");
+
+    // scale so that the average column holds 1.0, then fill each short column with the excess of a tall one
+    vector<double> scaled(n);
+    vector<size_t> small, large;
+    for (size_t i = 0; i < n; i++) {
+        aliases[i] = i;
+        scaled[i] = weights[i] * static_cast<double>(n) / sum;
+        if (scaled[i] < 1.0)
+            small.push_back(i);
+        else
+            large.push_back(i);
+    }
+
+    while (!small.empty() && !large.empty()) {
+        size_t less = small.back();
+        small.pop_back();
+        size_t more = large.back();
+        probs[less] = scaled[less];
+        aliases[less] = more;
+        scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+        if (scaled[more] < 1.0) {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    // whatever is left holds 1.0 up to rounding, and keeps its default probability of 1.0
+}
+
+size_t AliasTable::pick(Random& rand) const
+{
+    size_t column = rand.getRandomSize(0, probs.size());
+    if (probs[column] >= 1.0 || (probs[column] > 0.0 && rand.getRandomBool(probs[column])))
+        return column;
+    return aliases[column];
+}
+
+}  // namespace util
+}  // namespace proptest
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "proptest/api.hpp"
+#include "proptest/std/lang.hpp"
+#include "proptest/std/vector.hpp"
+
+/**
+ * @file alias_table.hpp
+ * @brief Constant-time sampling of an index by weight (Walker's alias method, as constructed by Vose)
+ */
+
+namespace proptest {
+
+class Random;
+
+namespace util {
+
+/**
+ * @brief Picks an index i with probability weights[i] / sum(weights)
+ *
+ * The table is built once in O(n). Each pick then costs one uniform index and one biased coin, however skewed the
+ * weights are.
+ */
+class PROPTEST_API AliasTable {
+public:
+    /// weights must be non-negative with a positive sum
+    explicit AliasTable(const vector<double>& weights);
+
+    size_t pick(Random& rand) const;
+
+    size_t size() const { return probs.size(); }
+
+private:
+    vector<double> probs;    ///< chance of keeping the column drawn
+    vector<size_t> aliases;  ///< index taken otherwise
+};
+
+}  // namespace util
+}  // namespace proptest
@@ -1,43 +1,97 @@
 #include "proptest/util/any.hpp"
 #include "proptest/std/exception.hpp"
 #include "proptest/std/string.hpp"
+#include <cstring>
 
 namespace proptest {
 
 const Any Any::empty;
 
-Any::Any(const Any& other) : ptr(other.ptr) {}
-Any::Any(Any&& other) : ptr(other.ptr) {}
+Any::Any() { initHolder(nullptr); }
 
-Any::~Any() {}
+Any::Any(const Any& other) { copyFrom(other); }
+Any::Any(Any&& other) { copyFrom(other); }
+
+Any::~Any() { destroy(); }
+
+void Any::initHolder(shared_ptr<AnyHolder> holderPtr)
+{
+    valueType = holderPtr ? &holderPtr->type() : nullptr;
+    valuePtr = holderPtr ? holderPtr->rawPtr() : nullptr;
+    ::new (static_cast<void*>(&ptr)) shared_ptr<AnyHolder>(util::move(holderPtr));
+}
+
+void Any::detach()
+{
+    ptr = ptr->clone();
+    valuePtr = ptr->rawPtr();
+}
+
+void Any::copyFrom(const Any& other)
+{
+    if (other.isInline()) {
+        valueType = other.valueType;
+        memcpy(storage, other.storage, inlineCapacity);
+        valuePtr = storage;
+    } else {
+        valueType = other.valueType;
+        valuePtr = other.valuePtr;
+        ::new (static_cast<void*>(&ptr)) shared_ptr<AnyHolder>(other.ptr);
+    }
+}
+
+void Any::destroy()
+{
+    if (!isInline())
+        ptr.~shared_ptr<AnyHolder>();
+}
+
+void Any::checkType(const type_info& requested, bool skipCheck) const
+{
+    if(isEmpty())
+        throw invalid_cast_error(__FILE__, __LINE__, "no value in an empty Any");
+    if(!skipCheck && *valueType != requested) {
+        throw invalid_cast_error(__FILE__, __LINE__, "cannot cast from " + string(valueType->name()) + " to " + string(requested.name()));
+    }
+}
 
 const type_info& Any::type() const {
-    if(!ptr) {
+    if(!valueType) {
         throw runtime_error(__FILE__, __LINE__, "empty ptr");
     }
-    return ptr->type();
+    return *valueType;
 }
 
 bool Any::isEmpty() const {
-    if((ptr.get() == nullptr) != !static_cast<bool>(ptr))
-        throw runtime_error(__FILE__, __LINE__, "somehow nullptr comparison misbehaves");
-    return !static_cast<bool>(ptr);
-    //return ptr.get() == nullptr;
+    return valueType == nullptr;
 }
 
 Any& Any::operator=(const Any& other) {
     if(!isEmpty() && !other.isEmpty() && type() != other.type())
         throw invalid_cast_error(__FILE__, __LINE__, "cannot assign from " + string(type().name()) + " to " + string(other.type().name()));
 
-    ptr = other.ptr;
+    if(this == &other)
+        return *this;
+
+    if(!isInline() && !other.isInline()) {
+        ptr = other.ptr;
+        valueType = other.valueType;
+        valuePtr = other.valuePtr;
+    } else {
+        destroy();
+        copyFrom(other);
+    }
     return *this;
 }
 
-Any::Any(const shared_ptr<AnyHolder>& holderPtr) : ptr(holderPtr) { }
-Any::Any(shared_ptr<AnyHolder>&& holderPtr) : ptr(holderPtr) { }
+Any::Any(const shared_ptr<AnyHolder>& holderPtr) { initHolder(holderPtr); }
+Any::Any(shared_ptr<AnyHolder>&& holderPtr) { initHolder(util::move(holderPtr)); }
 
 Any Any::clone() const
 {
+    // inline values are copied by value already
+    if(isInline())
+        return *this;
     return Any(ptr->clone());
 }
 
@@ -8,6 +8,7 @@
 #include "proptest/std/string.hpp"
 #include "proptest/std/exception.hpp"
 #include "proptest/util/define.hpp"
+#include "proptest/util/arena.hpp"
 
 namespace proptest
 {
@@ -42,6 +43,8 @@ struct PROPTEST_API AnyHolder {
 protected:
     // for cast()
     virtual const void* rawPtr() const = 0;
+
+    friend struct Any;
 };
 
 template <typename T> concept equality_check_available = requires(T a, T b) {
@@ -64,7 +67,7 @@ struct PROPTEST_API AnyVal : AnyHolder {
     }
 
     virtual shared_ptr<AnyHolder> clone() const override {
-        return util::make_shared<AnyVal<T>>(value);
+        return util::make_shared_node<AnyVal<T>>(value);
     }
 
     T value;
@@ -83,7 +86,7 @@ struct PROPTEST_API AnyLValRef : AnyHolder {
     }
 
     virtual shared_ptr<AnyHolder> clone() const override {
-        return util::make_shared<AnyLValRef<T>>(value); // note: inherently, lvalue reference is not a copy
+        return util::make_shared_node<AnyLValRef<T>>(value); // note: inherently, lvalue reference is not a copy
     }
 
     const T& value;
@@ -110,7 +113,7 @@ struct PROPTEST_API AnyRef : AnyHolder {
 
     virtual shared_ptr<AnyHolder> clone() const override {
         if constexpr(copy_constructible<T>)
-            return util::make_shared<AnyRef<T>>(*ptr);
+            return util::make_shared_node<AnyRef<T>>(*ptr);
         else
             throw runtime_error(__FILE__, __LINE__, "cannot clone AnyRef of a type with no copy constructor: " + string(type().name()));
     }
@@ -119,10 +122,22 @@ private:
     unique_ptr<T> ptr;
 };
 
+/**
+ * @brief Type-erased value holder
+ *
+ * Small trivially copyable values (e.g. `int`, `double`, pointers) are stored inline, so that constructing and
+ * copying them involves no heap allocation. Other values are kept in a holder that copies of the Any share until one
+ * of them is written to: getMutableRef() on a shared holder first gives the Any a copy of its own. Either way, a
+ * write through getMutableRef() is never seen by other copies. Values that cannot be copied and values held by
+ * lvalue reference are the exception; their copies refer to the same object.
+ *
+ * The type and address of the held value are cached in the Any itself, so that getRef() with the right type costs a
+ * pointer comparison and a load, with no virtual call into the holder.
+ */
 struct PROPTEST_API Any {
     static const Any empty;
 
-    Any() = default;
+    Any();
     virtual ~Any();
 
     Any(const Any& other);
@@ -131,14 +146,17 @@ struct PROPTEST_API Any {
     template <typename T>
         requires (!is_lvalue_reference_v<T>)
     Any(T&& t) {
-        if constexpr(is_fundamental_v<T>) {
-            ptr = util::make_shared<AnyVal<T>>(util::move(t));
+        if constexpr(isStoredInline<remove_cv_t<T>>) {
+            initInline<remove_cv_t<T>>(t);
+        }
+        else if constexpr(is_fundamental_v<T>) {
+            initHolder(util::make_shared_node<AnyVal<T>>(util::move(t)));
         }
         else if constexpr(is_copy_constructible_v<T>) {
-            ptr = util::make_shared<AnyVal<T>>(t);
+            initHolder(util::make_shared_node<AnyVal<T>>(t));
         }
         else if constexpr(is_move_constructible_v<T>) {
-            ptr = util::make_shared<AnyRef<T>>(util::move(t));
+            initHolder(util::make_shared_node<AnyRef<T>>(util::move(t)));
         }
         else {
             throw runtime_error(__FILE__, __LINE__, "Any cannot be constructed from a type that is neither copy-constructible nor move-constructible: " + string(typeid(T).name()));
@@ -149,31 +167,34 @@ struct PROPTEST_API Any {
     Any(const T& t) {
         static_assert(is_same_v<decay_t<T>, Any> || is_move_constructible_v<T> || is_copy_constructible_v<T>);
         if constexpr(is_lvalue_reference_v<T>) {
-            ptr = util::make_shared<AnyLValRef<decay_t<T>>>(t);
+            initHolder(util::make_shared_node<AnyLValRef<decay_t<T>>>(t));
+        }
+        else if constexpr(isStoredInline<T>) {
+            initInline<T>(t);
         }
         else if constexpr(is_fundamental_v<T> || is_copy_constructible_v<T>) {
-            ptr = util::make_shared<AnyVal<T>>(t);
+            initHolder(util::make_shared_node<AnyVal<T>>(t));
         }
         else {
-            ptr = util::make_shared<AnyRef<T>>(util::make_shared<T>(t));
+            initHolder(util::make_shared_node<AnyRef<T>>(util::make_shared<T>(t)));
         }
     }
 
     template <typename T>
-    Any(const shared_ptr<AnyLValRef<T>>& holderPtr) : ptr(holderPtr){}
+    Any(const shared_ptr<AnyLValRef<T>>& holderPtr) { initHolder(holderPtr); }
     template <typename T>
-    Any(shared_ptr<AnyLValRef<T>>&& holderPtr) : ptr(holderPtr){}
+    Any(shared_ptr<AnyLValRef<T>>&& holderPtr) { initHolder(holderPtr); }
 
     template <typename T>
-    Any(const shared_ptr<AnyRef<T>>& holderPtr) : ptr(holderPtr){}
+    Any(const shared_ptr<AnyRef<T>>& holderPtr) { initHolder(holderPtr); }
     template <typename T>
-    Any(shared_ptr<AnyRef<T>>&& holderPtr) : ptr(holderPtr){}
+    Any(shared_ptr<AnyRef<T>>&& holderPtr) { initHolder(holderPtr); }
 
     template <typename T>
-    Any(const shared_ptr<AnyVal<T>>& holderPtr) : ptr(holderPtr){}
+    Any(const shared_ptr<AnyVal<T>>& holderPtr) { initHolder(holderPtr); }
 
     template <typename T>
-    Any(shared_ptr<AnyVal<T>>&& holderPtr) : ptr(holderPtr){}
+    Any(shared_ptr<AnyVal<T>>&& holderPtr) { initHolder(holderPtr); }
 
     Any(const shared_ptr<AnyHolder>& holderPtr);
     Any(shared_ptr<AnyHolder>&& holderPtr);
@@ -189,12 +210,9 @@ struct PROPTEST_API Any {
         if constexpr(is_same_v<decay_t<T>, Any>)
             return *this;
         else {
-            if(!ptr)
-                throw invalid_cast_error(__FILE__, __LINE__, "no value in an empty Any");
-            if(!skipCheck && type() != typeid(T)) {
-                throw invalid_cast_error(__FILE__, __LINE__, "cannot cast from " + string(type().name()) + " to " + string(typeid(T).name()));
-            }
-            return ptr->getRef<T>();
+            if(valueType != &typeid(T))
+                checkType(typeid(T), skipCheck);
+            return static_cast<const decay_t<T>&>(*static_cast<const decay_t<T>*>(valuePtr));
         }
     }
 
@@ -203,12 +221,13 @@ struct PROPTEST_API Any {
         if constexpr(is_same_v<decay_t<T>, Any>)
             return *this;
         else {
-            if(!ptr)
-                throw invalid_cast_error(__FILE__, __LINE__, "no value in an empty Any");
-            if(!skipCheck && type() != typeid(T)) {
-                throw invalid_cast_error(__FILE__, __LINE__, "cannot cast from " + string(type().name()) + " to " + string(typeid(T).name()));
+            if(valueType != &typeid(T))
+                checkType(typeid(T), skipCheck);
+            if constexpr(copy_constructible<decay_t<T>>) {
+                if(!isInline() && ptr.use_count() > 1)
+                    detach();
             }
-            return ptr->getMutableRef<T>();
+            return *const_cast<decay_t<T>*>(static_cast<const decay_t<T>*>(valuePtr));
         }
     }
 
@@ -222,7 +241,37 @@ struct PROPTEST_API Any {
     bool isEmpty() const;
 
 private:
-    shared_ptr<AnyHolder> ptr;
+    static constexpr size_t inlineCapacity = 2 * sizeof(void*);
+
+    template <typename T>
+    static constexpr bool isStoredInline = is_trivially_copyable_v<T> && is_copy_constructible_v<T> && !is_array_v<T> &&
+        sizeof(T) <= inlineCapacity && alignof(T) <= alignof(void*);
+
+    template <typename T>
+    void initInline(const T& value) {
+        valueType = &typeid(T);
+        valuePtr = ::new (static_cast<void*>(storage)) T(value);
+    }
+
+    bool isInline() const { return valuePtr == storage; }
+
+    // slow path of getRef(): type_info objects of the same type may still differ in address across shared libraries
+    void checkType(const type_info& requested, bool skipCheck) const;
+
+    void initHolder(shared_ptr<AnyHolder> holderPtr);
+    // replaces a shared holder with a copy of its own, before the value is written to
+    void detach();
+    void copyFrom(const Any& other);
+    void destroy();
+
+    // type and address of the held value; both are null for an empty Any
+    const type_info* valueType = nullptr;
+    // points into storage when the value is stored inline; otherwise ptr is active and holds the value, if any
+    const void* valuePtr = nullptr;
+    union {
+        shared_ptr<AnyHolder> ptr;
+        alignas(void*) unsigned char storage[inlineCapacity];
+    };
 };
 
 namespace util {
@@ -247,16 +296,19 @@ Any make_any(Args&&... args)
     }
     else if constexpr(is_lvalue_reference_v<T>) {
         static_assert(sizeof...(Args) == 1, "an l-value reference must be provided as argument");
-        return Any{util::make_shared<AnyLValRef<decay_t<T>>>(util::forward<Args>(args)...)};
+        return Any{util::make_shared_node<AnyLValRef<decay_t<T>>>(util::forward<Args>(args)...)};
     }
     else if constexpr (sizeof...(Args) == 1 && (is_same_v<decay_t<Args>, unique_ptr<T>> && ...)) {
-        return Any(util::make_shared<AnyRef<T>>(util::forward<Args>(args)...));
+        return Any(util::make_shared_node<AnyRef<T>>(util::forward<Args>(args)...));
+    }
+    else if constexpr (is_trivially_copyable_v<T> && is_copy_constructible_v<T> && !is_array_v<T>) {
+        return Any(T(util::forward<Args>(args)...));
     }
     else if constexpr (is_fundamental_v<decay_t<T>> || is_copy_constructible_v<decay_t<T>>){
-        return Any{util::make_shared<AnyVal<T>>(util::forward<T>(T(util::forward<Args>(args)...)))};
+        return Any{util::make_shared_node<AnyVal<T>>(util::forward<T>(T(util::forward<Args>(args)...)))};
     }
     else {
-        return Any(util::make_shared<AnyRef<T>>(util::make_unique<T>(util::forward<Args>(args)...)));
+        return Any(util::make_shared_node<AnyRef<T>>(util::make_unique<T>(util::forward<Args>(args)...)));
     }
 }
 
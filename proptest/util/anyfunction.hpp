@@ -10,6 +10,10 @@ struct Callable1HolderBase {
     virtual ~Callable1HolderBase() {}
     virtual RET operator()(const Any& arg) = 0;
     virtual RET operator()(void* ptr) = 0;
+    // copy-constructs this holder into the inline storage of another Function1
+    virtual Callable1HolderBase* cloneInto(void* buffer) const = 0;
+    // holder for a copy of a Function1 that keeps this holder in shared storage (self)
+    virtual shared_ptr<Callable1HolderBase> copyShared(const shared_ptr<Callable1HolderBase>& self) const = 0;
 };
 
 template <typename Callable, typename RET, typename ARG>
@@ -28,16 +32,56 @@ struct Callable1Holder : public Callable1HolderBase<RET> {
         return callable(util::toCallableArg<ARG>(*reinterpret_cast<const decay_t<ARG>*>(ptr)));
     }
 
+    Callable1HolderBase<RET>* cloneInto(void* buffer) const override {
+        // only holders that fit the inline storage are ever stored there, so no other holder is constructed in it
+        if constexpr(util::isFunctionStoredInline<Callable1Holder, Callable>)
+            return ::new (buffer) Callable1Holder(*this);
+        else
+            throw runtime_error(__FILE__, __LINE__, "a callable that does not fit inline storage cannot be copied into it");
+    }
+
+    shared_ptr<Callable1HolderBase<RET>> copyShared(const shared_ptr<Callable1HolderBase<RET>>& self) const override {
+        if constexpr(util::isCallableStateful<Callable, ARG> && is_copy_constructible_v<decay_t<Callable>>)
+            return util::make_shared_node<Callable1Holder>(*this);
+        else
+            return self;
+    }
+
     decay_t<Callable> callable;
 };
 
 
+/**
+ * @brief Type-erased single-argument callable taking its argument as Any (or a raw pointer via callDirect)
+ *
+ * Like Function, callables with small captures are stored inline and copied along with the Function1, and copies
+ * never share the state of a callable that may change when called.
+ */
 template <typename RET>
 struct PROPTEST_API Function1
 {
+    using HolderBase = Callable1HolderBase<RET>;
+
     template <typename Callable>
         requires (!is_base_of_v<Function1<RET>, decay_t<Callable>>)
-    Function1(Callable&& c) : holder(util::make_shared<Callable1Holder<Callable, RET, typename function_traits<Callable>::argument_type_list::head>>(util::forward<Callable>(c))) {
+    Function1(Callable&& c) {
+        using Holder = Callable1Holder<Callable, RET, typename function_traits<Callable>::argument_type_list::head>;
+        if constexpr(util::isFunctionStoredInline<Holder, Callable>)
+            holder = ::new (static_cast<void*>(storage)) Holder(util::forward<Callable>(c));
+        else
+            initShared(util::make_shared_node<Holder>(util::forward<Callable>(c)));
+    }
+
+    Function1(const Function1& other) { copyFrom(other); }
+
+    ~Function1() { destroy(); }
+
+    Function1& operator=(const Function1& other) {
+        if(this != &other) {
+            destroy();
+            copyFrom(other);
+        }
+        return *this;
     }
 
     RET operator()(const Any& arg) const {
@@ -49,7 +93,38 @@ struct PROPTEST_API Function1
         return holder->operator()(static_cast<void*>(&arg));
     }
 
-    shared_ptr<Callable1HolderBase<RET>> holder;
+    // active holder; points into storage for inline callables, or at the shared holder otherwise
+    HolderBase* holder = nullptr;
+
+private:
+    bool isInline() const { return holder && static_cast<const void*>(holder) == static_cast<const void*>(storage); }
+
+    void initShared(shared_ptr<HolderBase> sharedHolder) {
+        ::new (static_cast<void*>(&shared)) shared_ptr<HolderBase>(util::move(sharedHolder));
+        holder = shared.get();
+    }
+
+    void copyFrom(const Function1& other) {
+        if(other.isInline())
+            holder = other.holder->cloneInto(storage);
+        else if(other.holder)
+            initShared(other.holder->copyShared(other.shared));
+        else
+            initShared(other.shared);
+    }
+
+    void destroy() {
+        if(isInline())
+            holder->~HolderBase();
+        else
+            shared.~shared_ptr<HolderBase>();
+        holder = nullptr;
+    }
+
+    union {
+        shared_ptr<HolderBase> shared;
+        alignas(void*) unsigned char storage[util::functionInlineCapacity];
+    };
 };
 
 template <typename RET, typename ARG>
@@ -0,0 +1,93 @@
+#include "proptest/util/arena.hpp"
+#include "proptest/std/thread.hpp"
+#include <cstdint>
+
+namespace proptest {
+namespace util {
+
+namespace {
+
+thread_local ShrinkArena* activeArena = nullptr;
+
+size_t roundUp(size_t size)
+{
+    return (size + ShrinkArena::chunkAlignment - 1) / ShrinkArena::chunkAlignment * ShrinkArena::chunkAlignment;
+}
+
+}  // namespace
+
+// aligned to its size, so that masking the address of an allocation gives its chunk
+struct alignas(ShrinkArena::chunkSize) ShrinkArena::Chunk
+{
+    static constexpr size_t dataSize = chunkSize - chunkAlignment;
+
+    // live allocations, plus one while the chunk is still being filled by its arena
+    atomic<size_t> refCount{1};
+    size_t used = 0;
+    alignas(chunkAlignment) unsigned char data[dataSize];
+
+    static Chunk* of(void* ptr)
+    {
+        return reinterpret_cast<Chunk*>(reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(chunkSize - 1));
+    }
+
+    void release()
+    {
+        if (refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+};
+
+ShrinkArena::ShrinkArena() : current(nullptr), chunkCount(0) {}
+
+ShrinkArena::~ShrinkArena()
+{
+    retireCurrent();
+}
+
+ShrinkArena* ShrinkArena::active()
+{
+    return activeArena;
+}
+
+void ShrinkArena::retireCurrent()
+{
+    if (current) {
+        current->release();
+        current = nullptr;
+    }
+}
+
+void* ShrinkArena::allocate(size_t size)
+{
+    static_assert(sizeof(Chunk) == chunkSize);
+    size = roundUp(size);
+    if (!current || current->used + size > Chunk::dataSize) {
+        retireCurrent();
+        current = new Chunk;
+        chunkCount++;
+    }
+    unsigned char* block = current->data + current->used;
+    current->used += size;
+    current->refCount.fetch_add(1, std::memory_order_relaxed);
+    return block;
+}
+
+void ShrinkArena::deallocate(void* ptr) noexcept
+{
+    if (ptr)
+        Chunk::of(ptr)->release();
+}
+
+ShrinkArenaScope::ShrinkArenaScope() : oldArena(activeArena)
+{
+    activeArena = &sessionArena;
+}
+
+ShrinkArenaScope::~ShrinkArenaScope()
+{
+    activeArena = oldArena;
+}
+
+}  // namespace util
+}  // namespace proptest
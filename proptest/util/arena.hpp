@@ -0,0 +1,136 @@
+#pragma once
+
+#include "proptest/api.hpp"
+#include "proptest/std/lang.hpp"
+#include "proptest/std/memory.hpp"
+
+/**
+ * @file arena.hpp
+ * @brief Per-session arena for the short-lived nodes (Any and Function holders) of a shrink tree
+ */
+
+namespace proptest {
+namespace util {
+
+/**
+ * @brief Chunked bump allocator used while a ShrinkArenaScope is active on the calling thread
+ *
+ * Allocation is a pointer bump in the current chunk. Chunks are aligned to their size, so the chunk of an allocation
+ * is found from its address and allocations carry no header. Each chunk counts its live allocations and is returned
+ * to the heap as a whole once it has been retired (filled up, or its arena ended) and its last allocation was
+ * released. Nodes may therefore safely outlive the session or be released from another thread.
+ */
+class PROPTEST_API ShrinkArena
+{
+public:
+    static constexpr size_t chunkSize = 64 * 1024;
+    /// largest allocation served from a chunk
+    static constexpr size_t maxChunkAllocation = chunkSize / 4;
+    /// alignment of every allocation served from a chunk
+    static constexpr size_t chunkAlignment = 16;
+
+    ShrinkArena();
+    ~ShrinkArena();
+    ShrinkArena(const ShrinkArena&) = delete;
+    ShrinkArena& operator=(const ShrinkArena&) = delete;
+
+    /// The calling thread's active arena, or nullptr if there is none
+    static ShrinkArena* active();
+
+    /// Whether an allocation of this size and alignment can be served from a chunk
+    static constexpr bool fitsInChunk(size_t size, size_t alignment)
+    {
+        return alignment <= chunkAlignment && size <= maxChunkAllocation;
+    }
+
+    /// Allocates from the current chunk; fitsInChunk(size, alignment) must hold
+    void* allocate(size_t size);
+    /// Releases memory obtained from allocate() of any arena, from any thread, even after that arena ended
+    static void deallocate(void* ptr) noexcept;
+
+    /// Number of chunks obtained from the heap by this arena so far
+    size_t numChunks() const { return chunkCount; }
+
+private:
+    struct Chunk;
+
+    void retireCurrent();
+
+    Chunk* current;
+    size_t chunkCount;
+
+    friend class ShrinkArenaScope;
+};
+
+/**
+ * @brief Activates a fresh ShrinkArena on the calling thread for the lifetime of the scope
+ *
+ * Scopes nest; the previously active arena is restored on exit.
+ */
+class PROPTEST_API ShrinkArenaScope
+{
+public:
+    ShrinkArenaScope();
+    ~ShrinkArenaScope();
+    ShrinkArenaScope(const ShrinkArenaScope&) = delete;
+    ShrinkArenaScope& operator=(const ShrinkArenaScope&) = delete;
+
+    const ShrinkArena& arena() const { return sessionArena; }
+
+private:
+    ShrinkArena sessionArena;
+    ShrinkArena* oldArena;
+};
+
+/**
+ * @brief Allocator drawing from a ShrinkArena, or from the heap if it has none, usable with allocate_shared
+ *
+ * allocate_shared keeps a copy in the control block to release the node with; the arena it names is only used to
+ * allocate, so the node may outlive it.
+ */
+template <typename T>
+struct ShrinkArenaAllocator
+{
+    using value_type = T;
+
+    explicit ShrinkArenaAllocator(ShrinkArena* _arena = nullptr) noexcept : arena(_arena) {}
+    template <typename U>
+    ShrinkArenaAllocator(const ShrinkArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(size_t n)
+    {
+        if (arena && ShrinkArena::fitsInChunk(n * sizeof(T), alignof(T)))
+            return static_cast<T*>(arena->allocate(n * sizeof(T)));
+        return allocator<T>().allocate(n);
+    }
+    void deallocate(T* ptr, size_t n) noexcept
+    {
+        if (arena && ShrinkArena::fitsInChunk(n * sizeof(T), alignof(T)))
+            ShrinkArena::deallocate(ptr);
+        else
+            allocator<T>().deallocate(ptr, n);
+    }
+
+    template <typename U>
+    bool operator==(const ShrinkArenaAllocator<U>& other) const noexcept { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ShrinkArenaAllocator<U>& other) const noexcept { return arena != other.arena; }
+
+    ShrinkArena* arena;
+};
+
+/**
+ * @brief make_shared for library-internal nodes (Any and Function holders), drawing from the active ShrinkArena
+ *
+ * Outside a shrink session this is plain make_shared.
+ */
+template <typename T, typename... ARGS>
+shared_ptr<T> make_shared_node(ARGS&&... args)
+{
+    if (ShrinkArena* arena = ShrinkArena::active())
+        return util::allocate_shared<T>(ShrinkArenaAllocator<T>(arena), util::forward<ARGS>(args)...);
+    return util::make_shared<T>(util::forward<ARGS>(args)...);
+}
+
+}  // namespace util
+}  // namespace proptest
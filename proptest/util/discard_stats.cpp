@@ -0,0 +1,49 @@
+#include "proptest/util/discard_stats.hpp"
+
+namespace proptest {
+namespace util {
+
+namespace {
+
+thread_local DiscardStats* discardStats = nullptr;
+
+}  // namespace
+
+void DiscardStats::countFilterDraw(bool accepted)
+{
+    if (filters.size() <= currentArg)
+        filters.resize(currentArg + 1);
+    FilterCount& count = filters[currentArg];
+    count.numDraws++;
+    if (accepted)
+        count.numAccepted++;
+}
+
+void DiscardStats::merge(const DiscardStats& other)
+{
+    numDiscarded += other.numDiscarded;
+    if (filters.size() < other.filters.size())
+        filters.resize(other.filters.size());
+    for (size_t i = 0; i < other.filters.size(); i++) {
+        filters[i].numDraws += other.filters[i].numDraws;
+        filters[i].numAccepted += other.filters[i].numAccepted;
+    }
+}
+
+DiscardStats* getDiscardStats()
+{
+    return discardStats;
+}
+
+DiscardStatsBinding::DiscardStatsBinding(DiscardStats* stats) : oldStats(discardStats)
+{
+    discardStats = stats;
+}
+
+DiscardStatsBinding::~DiscardStatsBinding()
+{
+    discardStats = oldStats;
+}
+
+}  // namespace util
+}  // namespace proptest
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "proptest/api.hpp"
+#include "proptest/std/lang.hpp"
+#include "proptest/std/vector.hpp"
+
+/**
+ * @file discard_stats.hpp
+ * @brief Counts of discarded runs and of values rejected by filters
+ */
+
+namespace proptest {
+namespace util {
+
+/// Draws a filter makes for one value before it gives up and discards the run (0 = no limit)
+constexpr uint32_t kDefaultMaxFilterAttempts = 10000;
+
+/// Draws of the filters in the generator of one argument
+struct PROPTEST_API FilterCount
+{
+    uint64_t numDraws = 0;
+    uint64_t numAccepted = 0;
+
+    double acceptanceRate() const { return numDraws == 0 ? 1.0 : static_cast<double>(numAccepted) / numDraws; }
+};
+
+/**
+ * @brief Discarded runs and filter draws of a forAll run
+ *
+ * A run is discarded by PROP_DISCARD, or by a filter that found no accepted value within maxFilterAttempts draws.
+ * Filter draws are counted by the argument being generated; nested filters add to the same count.
+ */
+struct PROPTEST_API DiscardStats
+{
+    uint64_t numDiscarded = 0;
+    vector<FilterCount> filters;  ///< by argument index
+    uint32_t maxFilterAttempts = kDefaultMaxFilterAttempts;
+    size_t currentArg = 0;        ///< argument being generated
+
+    void countFilterDraw(bool accepted);
+    void merge(const DiscardStats& other);
+};
+
+/// Discard stats of the run on the calling thread, or nullptr outside of a forAll run
+PROPTEST_API DiscardStats* getDiscardStats();
+
+/// Makes stats the discard stats of the calling thread for the lifetime of the binding
+class PROPTEST_API DiscardStatsBinding
+{
+public:
+    explicit DiscardStatsBinding(DiscardStats* stats);
+    ~DiscardStatsBinding();
+    DiscardStatsBinding(const DiscardStatsBinding&) = delete;
+    DiscardStatsBinding& operator=(const DiscardStatsBinding&) = delete;
+
+private:
+    DiscardStats* oldStats;
+};
+
+}  // namespace util
+}  // namespace proptest
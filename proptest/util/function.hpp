@@ -9,6 +9,7 @@
 #include "proptest/std/io.hpp"
 #include "proptest/std/tuple.hpp"
 #include "proptest/util/any.hpp"
+#include "proptest/util/arena.hpp"
 #include "proptest/util/function_traits.hpp"
 #include "proptest/typefwd.hpp"
 
@@ -44,10 +45,29 @@ concept isCallableOf =
      constructible_from<RET,
          const invoke_result_t<Callable, NormalizedType<ARGS>...>&>);
 
+namespace util {
+
+/// Inline storage size of Function and Function1: a holder's vtable pointer plus captures of up to three pointers
+inline constexpr size_t functionInlineCapacity = 4 * sizeof(void*);
+
+template <typename Holder, typename Callable>
+inline constexpr bool isFunctionStoredInline = sizeof(Holder) <= functionInlineCapacity &&
+    alignof(Holder) <= alignof(void*) && is_copy_constructible_v<decay_t<Callable>>;
+
+/// whether calling the callable may change it (e.g. a mutable lambda), so that copies of a Function must not share it
+template <typename Callable, typename... ARGS>
+inline constexpr bool isCallableStateful = !invocable<const decay_t<Callable>&, NormalizedType<ARGS>...>;
+
+}  // namespace util
+
 template <typename RET, typename...ARGS>
 struct CallableHolderBase {
     virtual ~CallableHolderBase() {}
     virtual RET operator()(const decay_t<ARGS>&... args) = 0;
+    // copy-constructs this holder into the inline storage of another Function
+    virtual CallableHolderBase* cloneInto(void* buffer) const = 0;
+    // holder for a copy of a Function that keeps this holder in shared storage (self)
+    virtual shared_ptr<CallableHolderBase> copyShared(const shared_ptr<CallableHolderBase>& self) const = 0;
 };
 
 template <typename Callable, typename RET, typename...ARGS>
@@ -68,33 +88,78 @@ struct CallableHolder : public CallableHolderBase<RET, ARGS...> {
             return callable(util::toCallableArg<ARGS>(args)...);
     }
 
+    CallableHolderBase<RET, ARGS...>* cloneInto(void* buffer) const override {
+        // only holders that fit the inline storage are ever stored there, so no other holder is constructed in it
+        if constexpr(util::isFunctionStoredInline<CallableHolder, Callable>)
+            return ::new (buffer) CallableHolder(*this);
+        else
+            throw runtime_error(__FILE__, __LINE__, "a callable that does not fit inline storage cannot be copied into it");
+    }
+
+    shared_ptr<CallableHolderBase<RET, ARGS...>> copyShared(const shared_ptr<CallableHolderBase<RET, ARGS...>>& self) const override {
+        if constexpr(util::isCallableStateful<Callable, ARGS...> && is_copy_constructible_v<decay_t<Callable>>)
+            return util::make_shared_node<CallableHolder>(*this);
+        else
+            return self;
+    }
+
     decay_t<Callable> callable;
 };
 
 template <typename F> struct Function;
 
+/**
+ * @brief Type-erased callable with signature RET(ARGS...)
+ *
+ * Callables with small captures (see util::functionInlineCapacity) are stored inline and copied along with the
+ * Function, so creating and copying such a Function does not allocate. Larger callables are kept in a holder that
+ * copies share, unless calling them may change them (e.g. a mutable lambda): those are copied along with the Function
+ * as well, so that copies never share state, wherever the callable is stored. Move-only callables cannot be copied and
+ * are always shared.
+ */
 template <typename RET, typename...ARGS>
 struct PROPTEST_API Function<RET(ARGS...)> {
     using ArgTuple = tuple<ARGS...>;
     using RetType = RET;
+    using HolderBase = CallableHolderBase<RET, ARGS...>;
     static constexpr size_t Arity = sizeof...(ARGS);
 
-    Function() = default;
+    Function() { ::new (static_cast<void*>(&shared)) shared_ptr<HolderBase>(); }
 
-    Function(const Function& other) : holder(other.holder) {}
+    Function(const Function& other) { copyFrom(other); }
 
     template <typename Callable>
         requires (!is_lvalue_reference_v<Callable> && !is_base_of_v<Function, decay_t<Callable>> && isCallableOf<Callable, RET, ARGS...>)
-    Function(Callable&& c) : holder(util::make_shared<CallableHolder<Callable, RET, ARGS...>>(util::forward<Callable>(c))) {
+    Function(Callable&& c) {
+        using Holder = CallableHolder<Callable, RET, ARGS...>;
+        if constexpr(util::isFunctionStoredInline<Holder, Callable>)
+            holder = ::new (static_cast<void*>(storage)) Holder(util::forward<Callable>(c));
+        else
+            initShared(util::make_shared_node<Holder>(util::forward<Callable>(c)));
     }
 
     template <typename Callable>
         requires (!is_base_of_v<Function, decay_t<Callable>> && isCallableOf<Callable, RET, ARGS...>)
-    Function(const Callable& c) : holder(util::make_shared<CallableHolder<Callable, RET, ARGS...>, const Callable&>(c)) {
+    Function(const Callable& c) {
+        using Holder = CallableHolder<Callable, RET, ARGS...>;
+        if constexpr(util::isFunctionStoredInline<Holder, Callable>)
+            holder = ::new (static_cast<void*>(storage)) Holder(c);
+        else
+            initShared(util::make_shared_node<Holder>(c));
+    }
+
+    ~Function() { destroy(); }
+
+    Function& operator=(const Function& other) {
+        if(this != &other) {
+            destroy();
+            copyFrom(other);
+        }
+        return *this;
     }
 
     operator bool() const {
-        return static_cast<bool>(holder);
+        return holder != nullptr;
     }
 
     RET operator()(const decay_t<ARGS>&... args) const {
@@ -108,7 +173,38 @@ struct PROPTEST_API Function<RET(ARGS...)> {
             return holder->operator()(args...);
     }
 
-    mutable shared_ptr<CallableHolderBase<RET, ARGS...>> holder;
+    // active holder; points into storage for inline callables, or at the shared holder otherwise
+    HolderBase* holder = nullptr;
+
+private:
+    bool isInline() const { return holder && static_cast<const void*>(holder) == static_cast<const void*>(storage); }
+
+    void initShared(shared_ptr<HolderBase> sharedHolder) {
+        ::new (static_cast<void*>(&shared)) shared_ptr<HolderBase>(util::move(sharedHolder));
+        holder = shared.get();
+    }
+
+    void copyFrom(const Function& other) {
+        if(other.isInline())
+            holder = other.holder->cloneInto(storage);
+        else if(other.holder)
+            initShared(other.holder->copyShared(other.shared));
+        else
+            initShared(other.shared);
+    }
+
+    void destroy() {
+        if(isInline())
+            holder->~HolderBase();
+        else
+            shared.~shared_ptr<HolderBase>();
+        holder = nullptr;
+    }
+
+    union {
+        shared_ptr<HolderBase> shared;
+        alignas(void*) unsigned char storage[util::functionInlineCapacity];
+    };
 };
 
 } // namespace proptest
@@ -0,0 +1,56 @@
+#include "proptest/util/start_gate.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace proptest {
+namespace util {
+
+namespace {
+
+/// tells the CPU that the thread is spinning, so that it yields pipeline resources to its sibling hyperthread
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+}  // namespace
+
+StartGate::StartGate(uint32_t _numParties, StartGateMode _mode, uint32_t _spinCount)
+    : numParties(_numParties), mode(_mode), spinCount(_spinCount)
+{
+}
+
+void StartGate::arriveAndWait()
+{
+    if (numArrived.fetch_add(1, std::memory_order_acq_rel) + 1 >= numParties) {
+        open.store(true, std::memory_order_release);
+        if (mode != StartGateMode::Spin)
+            open.notify_all();
+        return;
+    }
+
+    if (mode == StartGateMode::Spin) {
+        while (!open.load(std::memory_order_acquire))
+            cpuRelax();
+        return;
+    }
+
+    if (mode == StartGateMode::SpinThenBlock) {
+        for (uint32_t i = 0; i < spinCount; i++) {
+            if (open.load(std::memory_order_acquire))
+                return;
+            cpuRelax();
+        }
+    }
+    while (!open.load(std::memory_order_acquire))
+        open.wait(false, std::memory_order_acquire);
+}
+
+}  // namespace util
+}  // namespace proptest
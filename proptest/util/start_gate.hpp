@@ -0,0 +1,52 @@
+#pragma once
+
+#include "proptest/api.hpp"
+#include "proptest/std/lang.hpp"
+#include "proptest/std/thread.hpp"
+
+/**
+ * @file start_gate.hpp
+ * @brief One-shot gate that releases a group of threads together once all of them have arrived
+ */
+
+namespace proptest {
+namespace util {
+
+/// How threads wait at a StartGate
+enum class StartGateMode {
+    SpinThenBlock,  ///< spin for a short while, then block until the gate opens
+    Spin,           ///< spin until the gate opens: tightest release, but each waiter keeps a core busy
+    Block,          ///< block right away: no CPU is used while waiting, at the cost of a wake-up latency
+};
+
+/**
+ * @brief Releases numParties threads at once, when the last of them arrives
+ *
+ * Spinning waiters pause the CPU between checks. Blocking waiters sleep on the gate's flag (a futex on Linux) and
+ * are woken by the last arrival.
+ */
+class PROPTEST_API StartGate {
+public:
+    /// checks of the flag a SpinThenBlock waiter makes before it blocks
+    static constexpr uint32_t defaultSpinCount = 4096;
+
+    explicit StartGate(uint32_t numParties, StartGateMode mode = StartGateMode::SpinThenBlock,
+                       uint32_t spinCount = defaultSpinCount);
+    StartGate(const StartGate&) = delete;
+    StartGate& operator=(const StartGate&) = delete;
+
+    /// arrives at the gate and returns once all numParties threads have arrived
+    void arriveAndWait();
+
+    bool isOpen() const { return open.load(std::memory_order_acquire); }
+
+private:
+    const uint32_t numParties;
+    const StartGateMode mode;
+    const uint32_t spinCount;
+    atomic<uint32_t> numArrived{0};
+    atomic<bool> open{false};
+};
+
+}  // namespace util
+}  // namespace proptest
@@ -0,0 +1,80 @@
+#include "proptest/util/thread_pool.hpp"
+
+namespace proptest {
+namespace util {
+
+ThreadPool::ThreadPool(size_t numThreads)
+{
+    workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; i++)
+        workers.emplace_back([this]() { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> guard(mtx);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void ThreadPool::workerLoop()
+{
+    unique_lock<mutex> lock(mtx);
+    while (true) {
+        workAvailable.wait(lock, [this]() { return stopping || nextIndex < batchSize; });
+        if (stopping)
+            return;
+        size_t index = nextIndex++;
+        Function<void(size_t)> task = batchTask;
+        lock.unlock();
+        std::exception_ptr error;
+        try {
+            task(index);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+        if (error)
+            errors[index] = error;
+        if (++numFinished == batchSize)
+            workDone.notify_all();
+    }
+}
+
+void ThreadPool::parallelFor(size_t n, Function<void(size_t)> task)
+{
+    if (n == 0)
+        return;
+
+    if (workers.empty()) {
+        for (size_t i = 0; i < n; i++)
+            task(i);
+        return;
+    }
+
+    lock_guard<mutex> batchGuard(batchMtx);
+    unique_lock<mutex> lock(mtx);
+    batchTask = task;
+    batchSize = n;
+    nextIndex = 0;
+    numFinished = 0;
+    errors.assign(n, nullptr);
+    workAvailable.notify_all();
+    workDone.wait(lock, [this]() { return numFinished == batchSize; });
+
+    // reset the batch so that idle workers keep waiting
+    batchSize = 0;
+    nextIndex = 0;
+    batchTask = Function<void(size_t)>();
+    for (auto& error : errors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
+
+}  // namespace util
+}  // namespace proptest
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "proptest/api.hpp"
+#include "proptest/std/lang.hpp"
+#include "proptest/std/vector.hpp"
+#include "proptest/std/thread.hpp"
+#include "proptest/util/function.hpp"
+#include <exception>
+
+/**
+ * @file thread_pool.hpp
+ * @brief Fixed-size pool of worker threads for running batches of independent tasks
+ */
+
+namespace proptest {
+namespace util {
+
+class PROPTEST_API ThreadPool
+{
+public:
+    explicit ThreadPool(size_t numThreads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    /**
+     * @brief Runs task(0) ... task(n-1) on the pool and waits for all of them to finish
+     *
+     * A pool with no workers runs the tasks on the calling thread. Concurrent calls are serialized.
+     * If any task throws, the exception of the lowest-indexed failing task is rethrown once the batch is over.
+     */
+    void parallelFor(size_t n, Function<void(size_t)> task);
+
+private:
+    void workerLoop();
+
+    vector<thread> workers;
+    // held by the caller of parallelFor for the whole batch
+    mutex batchMtx;
+    mutex mtx;
+    condition_variable workAvailable;
+    condition_variable workDone;
+
+    // current batch
+    Function<void(size_t)> batchTask;
+    size_t batchSize = 0;
+    size_t nextIndex = 0;
+    size_t numFinished = 0;
+    vector<std::exception_ptr> errors;
+    bool stopping = false;
+};
+
+}  // namespace util
+}  // namespace proptest
@@ -0,0 +1,94 @@
+#include "proptest/util/time_budget.hpp"
+#include <cstdlib>
+
+namespace proptest {
+namespace util {
+
+TimeBudgetCharge::TimeBudgetCharge() : startedTime(steady_clock::now()) {}
+
+TimeBudgetCharge::~TimeBudgetCharge()
+{
+    TimeBudget& budget = TimeBudget::global();
+    if (budget.isActive())
+        budget.charge(duration_cast<milliseconds>(steady_clock::now() - startedTime).count());
+}
+
+TimeBudget& TimeBudget::global()
+{
+    static TimeBudget* instance = []() {
+        auto* budget = new TimeBudget();
+        const char* envTotal = std::getenv("PROPTEST_TIME_BUDGET_MS");
+        const char* envProperties = std::getenv("PROPTEST_TIME_BUDGET_PROPERTIES");
+        if (envTotal && envProperties)
+            budget->set(std::strtoull(envTotal, nullptr, 10), static_cast<uint32_t>(std::strtoul(envProperties, nullptr, 10)));
+        return budget;
+    }();
+    return *instance;
+}
+
+void TimeBudget::set(uint64_t totalMs, uint32_t numProperties)
+{
+    lock_guard<mutex> guard(mtx);
+    active = numProperties > 0;
+    remainingMs = totalMs;
+    remainingProperties = numProperties;
+}
+
+void TimeBudget::clear()
+{
+    lock_guard<mutex> guard(mtx);
+    active = false;
+    remainingMs = 0;
+    remainingProperties = 0;
+}
+
+bool TimeBudget::isActive() const
+{
+    lock_guard<mutex> guard(mtx);
+    return active;
+}
+
+uint64_t TimeBudget::nextShareMs() const
+{
+    lock_guard<mutex> guard(mtx);
+    if (!active)
+        return 0;
+    // properties beyond the announced count split whatever is left among themselves, one at a time
+    const uint64_t share = remainingMs / (remainingProperties > 0 ? remainingProperties : 1);
+    return share > 0 ? share : 1;
+}
+
+void TimeBudget::charge(uint64_t elapsedMs)
+{
+    lock_guard<mutex> guard(mtx);
+    if (!active)
+        return;
+    remainingMs = elapsedMs < remainingMs ? remainingMs - elapsedMs : 0;
+    if (remainingProperties > 0)
+        remainingProperties--;
+}
+
+uint64_t TimeBudget::getRemainingMs() const
+{
+    lock_guard<mutex> guard(mtx);
+    return remainingMs;
+}
+
+uint32_t planNumRuns(uint32_t numRunsCap, uint32_t numDone, double elapsedMs, uint64_t budgetMs)
+{
+    if (numDone >= numRunsCap)
+        return numRunsCap;
+    const double budget = static_cast<double>(budgetMs);
+    if (elapsedMs >= budget)
+        return numDone;
+    if (numDone == 0 || elapsedMs <= 0.0)
+        return numRunsCap;
+    const double perRunMs = elapsedMs / numDone;
+    const double numMore = (budget - elapsedMs) / perRunMs;
+    if (numMore >= static_cast<double>(numRunsCap - numDone))
+        return numRunsCap;
+    return numDone + static_cast<uint32_t>(numMore);
+}
+
+}  // namespace util
+}  // namespace proptest
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "proptest/api.hpp"
+#include "proptest/std/lang.hpp"
+#include "proptest/std/thread.hpp"
+#include "proptest/std/chrono.hpp"
+
+/**
+ * @file time_budget.hpp
+ * @brief Wall-clock budget shared by the properties of a test binary
+ */
+
+namespace proptest {
+namespace util {
+
+/**
+ * @brief Splits a total wall-clock budget across the properties of a test binary
+ *
+ * Each property run that has no budget of its own takes an equal share of what is left for the properties that have
+ * not run yet, and is charged the time it actually took. Time a fast property leaves unused goes to the later ones,
+ * and a slow property cannot take more than its share.
+ *
+ * The global instance is configured with set(), or from the PROPTEST_TIME_BUDGET_MS and
+ * PROPTEST_TIME_BUDGET_PROPERTIES environment variables when both are present.
+ */
+class PROPTEST_API TimeBudget
+{
+public:
+    TimeBudget() = default;
+    TimeBudget(const TimeBudget&) = delete;
+    TimeBudget& operator=(const TimeBudget&) = delete;
+
+    static TimeBudget& global();
+
+    /// Shares totalMs across numProperties property runs
+    void set(uint64_t totalMs, uint32_t numProperties);
+    void clear();
+    bool isActive() const;
+
+    /// Budget of the next property run: an equal share of the remaining time (at least 1ms), or 0 if inactive
+    uint64_t nextShareMs() const;
+    /// Records a finished property run that took elapsedMs
+    void charge(uint64_t elapsedMs);
+
+    uint64_t getRemainingMs() const;
+
+private:
+    mutable mutex mtx;
+    bool active = false;
+    uint64_t remainingMs = 0;
+    uint32_t remainingProperties = 0;
+};
+
+/**
+ * @brief Charges the time from its construction to its destruction to TimeBudget::global(), if that is active
+ *
+ * Spans a whole property run, shrinking included.
+ */
+class PROPTEST_API TimeBudgetCharge
+{
+public:
+    TimeBudgetCharge();
+    ~TimeBudgetCharge();
+    TimeBudgetCharge(const TimeBudgetCharge&) = delete;
+    TimeBudgetCharge& operator=(const TimeBudgetCharge&) = delete;
+
+private:
+    steady_clock::time_point startedTime;
+};
+
+/// Number of runs a budgeted property makes before estimating its per-case cost
+constexpr uint32_t kBudgetCalibrationRuns = 10;
+
+/**
+ * @brief Plans the number of runs that fit in a time budget
+ *
+ * @param numRunsCap upper bound on the number of runs
+ * @param numDone runs already made
+ * @param elapsedMs time the runs already made took
+ * @param budgetMs time budget of the whole run loop
+ * @return total number of runs, between numDone and numRunsCap
+ */
+PROPTEST_API uint32_t planNumRuns(uint32_t numRunsCap, uint32_t numDone, double elapsedMs, uint64_t budgetMs);
+
+}  // namespace util
+}  // namespace proptest